@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <stdexcept>
+
+#include "benchmark.hpp"
+
+Benchmark::Benchmark(const std::size_t repetitions, const std::chrono::nanoseconds minRepetitionTime) :
+    repetitions(repetitions), minRepetitionTime(minRepetitionTime)
+{
+    if (repetitions < 2)
+        throw std::runtime_error("A benchmark needs at least 2 repetitions");
+}
+
+void Benchmark::addResult(const std::string &name, const std::size_t batchSize, const std::size_t calls,
+                          const std::vector<double> &nsPerOp)
+{
+    const double count = static_cast<double>(nsPerOp.size());
+    const double mean = std::accumulate(nsPerOp.begin(), nsPerOp.end(), 0.0) / count;
+    double squaredDeviations = 0;
+    for (const double ns : nsPerOp) {
+        squaredDeviations += (ns - mean) * (ns - mean);
+    }
+    const auto [min, max] = std::minmax_element(nsPerOp.begin(), nsPerOp.end());
+    this->results.push_back(Result{
+        name,
+        batchSize,
+        nsPerOp.size(),
+        calls,
+        mean,
+        // The sample variance, as the repetitions are a sample of all possible runs.
+        squaredDeviations / (count - 1),
+        *min,
+        *max,
+        1e9 / mean,
+    });
+}
+
+const std::vector<Benchmark::Result>& Benchmark::getResults(void) const noexcept
+{
+    return this->results;
+}
+
+void Benchmark::writeJson(std::ostream &out) const
+{
+    // The names are plain identifiers, so they need no escaping.
+    out << std::setprecision(6) << "{\n    \"unit\": \"ns/op\",\n    \"benchmarks\": [";
+    for (std::size_t i = 0; i < this->results.size(); ++i) {
+        const Result &result = this->results[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "        {\"name\": \"" << result.name << "\""
+            << ", \"batch_size\": " << result.batchSize
+            << ", \"repetitions\": " << result.repetitions
+            << ", \"calls_per_repetition\": " << result.callsPerRepetition
+            << ", \"mean\": " << result.meanNs
+            << ", \"variance\": " << result.varianceNs
+            << ", \"min\": " << result.minNs
+            << ", \"max\": " << result.maxNs
+            << ", \"ops_per_second\": " << result.throughput << "}";
+    }
+    out << "\n    ]\n}\n";
+}
+
+void Benchmark::writeTable(std::ostream &out) const
+{
+    std::size_t nameWidth = 4;
+    for (const Result &result : this->results) {
+        nameWidth = std::max(nameWidth, result.name.size());
+    }
+    out << std::left << std::setw(nameWidth) << "name" << std::right
+        << std::setw(8) << "batch" << std::setw(12) << "ns/op" << std::setw(12) << "stddev"
+        << std::setw(12) << "min" << std::setw(16) << "ops/s" << "\n";
+    out << std::fixed;
+    for (const Result &result : this->results) {
+        out << std::left << std::setw(nameWidth) << result.name << std::right
+            << std::setw(8) << result.batchSize
+            << std::setprecision(3) << std::setw(12) << result.meanNs
+            << std::setw(12) << std::sqrt(result.varianceNs)
+            << std::setw(12) << result.minNs
+            << std::setprecision(0) << std::setw(16) << result.throughput << "\n";
+    }
+    out << std::defaultfloat;
+}
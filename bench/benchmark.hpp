@@ -0,0 +1,90 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**Keep the compiler from optimizing away the computation of value, without adding any instructions.*/
+template <typename T>
+inline void doNotOptimize(const T &value) noexcept
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**Runs and times benchmarks, and reports the results.
+ * A benchmark is a function which performs batchSize operations. It is first called until it warmed up the caches, and
+ * then timed over a number of repetitions. Every repetition calls it as often as needed to run for at least
+ * minRepetitionTime, so the clock resolution does not matter. The reported numbers are per operation, not per call.*/
+class Benchmark {
+    public:
+        struct Result {
+            std::string name;
+            std::size_t batchSize;
+            std::size_t repetitions;
+            /**How often the function was called per repetition.*/
+            std::size_t callsPerRepetition;
+            /**Nanoseconds per operation, over the repetitions.*/
+            double meanNs;
+            double varianceNs;
+            double minNs;
+            double maxNs;
+            /**Operations per second, derived from meanNs.*/
+            double throughput;
+        };
+    private:
+        std::size_t repetitions;
+        std::chrono::nanoseconds minRepetitionTime;
+        std::vector<Result> results;
+
+        template <typename Function>
+        static std::chrono::nanoseconds time(Function &function, const std::size_t calls);
+        void addResult(const std::string &name, const std::size_t batchSize, const std::size_t calls,
+                       const std::vector<double> &nsPerOp);
+    public:
+        /**@param repetitions How often every benchmark is timed. Must be at least 2, so there is a variance.
+         * @param minRepetitionTime The minimal duration of one repetition.*/
+        explicit Benchmark(const std::size_t repetitions = 20,
+                           const std::chrono::nanoseconds minRepetitionTime = std::chrono::milliseconds(5));
+
+        /**Time function, which performs batchSize operations per call, and store the result under name.*/
+        template <typename Function>
+        void run(const std::string &name, const std::size_t batchSize, Function function);
+
+        const std::vector<Result>& getResults(void) const noexcept;
+        /**Write the results as a JSON document, to be compared by tools.*/
+        void writeJson(std::ostream &out) const;
+        /**Write the results as a table, to be read by humans.*/
+        void writeTable(std::ostream &out) const;
+};
+
+template <typename Function>
+std::chrono::nanoseconds Benchmark::time(Function &function, const std::size_t calls)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < calls; ++i) {
+        function();
+    }
+    return std::chrono::steady_clock::now() - start;
+}
+
+template <typename Function>
+void Benchmark::run(const std::string &name, const std::size_t batchSize, Function function)
+{
+    // Double the number of calls until a repetition takes long enough. This also warms up the caches.
+    std::size_t calls = 1;
+    while (time(function, calls) < this->minRepetitionTime) {
+        calls *= 2;
+    }
+    std::vector<double> nsPerOp;
+    nsPerOp.reserve(this->repetitions);
+    for (std::size_t i = 0; i < this->repetitions; ++i) {
+        const std::chrono::nanoseconds elapsed = time(function, calls);
+        nsPerOp.push_back(static_cast<double>(elapsed.count()) / static_cast<double>(calls * batchSize));
+    }
+    addResult(name, batchSize, calls, nsPerOp);
+}
+
+#endif //BENCHMARK_HPP
@@ -0,0 +1,213 @@
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "lookAtMatrix.hpp"
+#include "matrix.hpp"
+#include "openglMatrix.hpp"
+#include "trig.hpp"
+#include "vector.hpp"
+
+// Benchmarks of the math code, which runs without a window or GL context.
+// Usage: final_bench [--repetitions n] [--output file.json]
+// The JSON goes to the output file, or to stdout. A table of the same results always goes to stderr.
+
+namespace {
+    /**The batch sizes: a small scene, and one with many animated objects.*/
+    constexpr std::size_t batchSizes[] = {64, 4096};
+
+    class RandomFloats {
+        private:
+            std::mt19937 generator;
+            std::uniform_real_distribution<float> distribution;
+        public:
+            // A fixed seed, so every run works on the same data.
+            explicit RandomFloats(const float min = -1, const float max = 1) : generator(12345), distribution(min, max)
+            {}
+            float operator()(void)
+            {
+                return distribution(generator);
+            }
+            Vector3 vector3(void)
+            {
+                return Vector3((*this)(), (*this)(), (*this)());
+            }
+            Vector4 vector4(void)
+            {
+                return Vector4((*this)(), (*this)(), (*this)(), (*this)());
+            }
+            Matrix4 matrix4(void)
+            {
+                std::array<float, 16> elements;
+                for (float &f : elements) {
+                    f = (*this)();
+                }
+                return Matrix4(elements);
+            }
+    };
+
+    void benchmarkMatrix4(Benchmark &benchmark, const std::size_t n)
+    {
+        RandomFloats random;
+        std::vector<Matrix4> lhs, rhs, out(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            lhs.push_back(random.matrix4());
+            rhs.push_back(random.matrix4());
+        }
+        benchmark.run("matrix4_multiply_assign", n, [&]() {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = lhs[i];
+                out[i] *= rhs[i];
+            }
+            doNotOptimize(out.data());
+        });
+    }
+
+    void benchmarkVectors(Benchmark &benchmark, const std::size_t n)
+    {
+        RandomFloats random;
+        std::vector<Vector4> vec4, vec4Out(n);
+        std::vector<Vector3> lhs, rhs, vec3Out(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            vec4.push_back(random.vector4());
+            lhs.push_back(random.vector3());
+            rhs.push_back(random.vector3());
+        }
+        benchmark.run("vector4_normalize", n, [&]() {
+            for (std::size_t i = 0; i < n; ++i) {
+                vec4Out[i] = Vector4::normalize(vec4[i]);
+            }
+            doNotOptimize(vec4Out.data());
+        });
+        benchmark.run("vector3_cross_product", n, [&]() {
+            for (std::size_t i = 0; i < n; ++i) {
+                vec3Out[i] = Vector3::crossProduct(lhs[i], rhs[i]);
+            }
+            doNotOptimize(vec3Out.data());
+        });
+
+        // The update of ViewMatrix, once through the expression templates and once written out by hand. The two should
+        // take the same time.
+        const float speed = 0.01f;
+        benchmark.run("vector3_expression_multiply_add", n, [&]() {
+            for (std::size_t i = 0; i < n; ++i) {
+                vec3Out[i] = lhs[i] + 1.0f * rhs[i] * speed;
+            }
+            doNotOptimize(vec3Out.data());
+        });
+        benchmark.run("vector3_hand_written_multiply_add", n, [&]() {
+            for (std::size_t i = 0; i < n; ++i) {
+                vec3Out[i] = Vector3(lhs[i].x() + 1.0f * rhs[i].x() * speed,
+                                     lhs[i].y() + 1.0f * rhs[i].y() * speed,
+                                     lhs[i].z() + 1.0f * rhs[i].z() * speed);
+            }
+            doNotOptimize(vec3Out.data());
+        });
+    }
+
+    void benchmarkOpenGlMatrix(Benchmark &benchmark, const std::size_t n)
+    {
+        RandomFloats random(-3.14f, 3.14f);
+        std::vector<OpenGlMatrix> matrices(n);
+        std::vector<float> angles;
+        for (std::size_t i = 0; i < n; ++i) {
+            matrices[i].setTranslate(random(), random(), random()).setScale(1, 2, 3).setRotate(random(), 0, 0);
+            angles.push_back(random());
+        }
+        // Nothing changed, so data() returns the cached matrix.
+        benchmark.run("openglmatrix_data_cached", n, [&]() {
+            for (OpenGlMatrix &mat : matrices) {
+                doNotOptimize(mat.data());
+            }
+        });
+        // An animated object: its rotation changes every frame.
+        benchmark.run("openglmatrix_data_rotated", n, [&]() {
+            for (std::size_t i = 0; i < n; ++i) {
+                matrices[i].setRotate(angles[i], angles[i], 0);
+                doNotOptimize(matrices[i].data());
+            }
+        });
+    }
+
+    void benchmarkLookAt(Benchmark &benchmark, const std::size_t n)
+    {
+        constexpr Vector3 worldUp = Vector3(0, 1, 0);
+        RandomFloats random;
+        std::vector<Vector3> directions, positions;
+        std::vector<Matrix4> out(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            directions.push_back(Vector3::normalize(Vector3(random(), random(), 1)));
+            positions.push_back(random.vector3());
+        }
+        benchmark.run("look_at_matrix", n, [&]() {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = createLookAtMatrix(worldUp, directions[i], positions[i]);
+            }
+            doNotOptimize(out.data());
+        });
+    }
+
+    void benchmarkTrig(Benchmark &benchmark, const std::size_t n)
+    {
+        RandomFloats random(-10, 10);
+        std::vector<float> angles, sin(n), cos(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            angles.push_back(random());
+        }
+        // sinCos follows the FAST_TRIG build option, fastSinCos is always the approximation.
+        benchmark.run("sin_cos_batched", n, [&]() {
+            Trig::sinCos(angles.data(), sin.data(), cos.data(), n);
+            doNotOptimize(sin.data());
+            doNotOptimize(cos.data());
+        });
+        benchmark.run("fast_sin_cos_batched", n, [&]() {
+            Trig::fastSinCos(angles.data(), sin.data(), cos.data(), n);
+            doNotOptimize(sin.data());
+            doNotOptimize(cos.data());
+        });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t repetitions = 20;
+    const char *outputPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            repetitions = std::stoul(argv[++i]);
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--repetitions n] [--output file.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    Benchmark benchmark(repetitions);
+    for (const std::size_t n : batchSizes) {
+        benchmarkMatrix4(benchmark, n);
+        benchmarkVectors(benchmark, n);
+        benchmarkOpenGlMatrix(benchmark, n);
+        benchmarkLookAt(benchmark, n);
+        benchmarkTrig(benchmark, n);
+    }
+
+    benchmark.writeTable(std::cerr);
+    if (outputPath == nullptr) {
+        benchmark.writeJson(std::cout);
+    } else {
+        std::ofstream out(outputPath);
+        benchmark.writeJson(out);
+        if (!out) {
+            std::cerr << "Could not write " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
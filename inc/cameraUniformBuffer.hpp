@@ -0,0 +1,57 @@
+#ifndef CAMERA_UNIFORM_BUFFER_HPP
+#define CAMERA_UNIFORM_BUFFER_HPP
+
+#include "glad/glad.h"
+#include "matrix.hpp"
+#include "vector.hpp"
+
+class ViewMatrix;
+class ProjectionMatrix;
+
+/**The camera data of a frame, in a uniform buffer object shared by every shader program. Shaders declare it as
+ *
+ *     layout (std140) uniform Camera {
+ *         mat4 view;
+ *         mat4 projection;
+ *         mat4 viewProjection;
+ *         mat4 overlayProjection;
+ *         vec4 cameraPosition;
+ *     };
+ *
+ * overlayProjection is the projection of everything drawn on top of the scene, like text. The w of cameraPosition is 1.
+ * ShaderProgram binds every block named Camera to bindingPoint when it links the program, and the constructor binds
+ * the buffer to it, so no shader program needs to be told about the buffer.*/
+class CameraUniformBuffer {
+    private:
+        /**The uniform block in the std140 layout: matrices are column based, and the vec4 follows without padding.*/
+        struct Block {
+            ColumnMajorMatrix4 view;
+            ColumnMajorMatrix4 projection;
+            ColumnMajorMatrix4 viewProjection;
+            ColumnMajorMatrix4 overlayProjection;
+            Vector4 cameraPosition;
+        };
+        static_assert(sizeof(Block) == 4 * 16 * sizeof(float) + 4 * sizeof(float), "Block must match std140");
+
+        GLuint buffer;
+        /**The contents of buffer.*/
+        Block block;
+    public:
+        /**The uniform buffer binding point of the Camera block.*/
+        static constexpr GLuint bindingPoint = 0;
+        /**The name of the uniform block in the shaders.*/
+        static constexpr const char* blockName = "Camera";
+
+        CameraUniformBuffer(void);
+        ~CameraUniformBuffer(void);
+
+        CameraUniformBuffer(const CameraUniformBuffer&) = delete;
+        CameraUniformBuffer& operator=(const CameraUniformBuffer&) = delete;
+
+        /**Write the data of this frame. Call it once per frame, before drawing. Nothing is uploaded if nothing changed
+         * since the last call.
+         * @param overlay The projection for overlays, like text.*/
+        void update(const ViewMatrix &view, const ProjectionMatrix &projection, const ProjectionMatrix &overlay);
+};
+
+#endif //CAMERA_UNIFORM_BUFFER_HPP
@@ -0,0 +1,29 @@
+#ifndef EMBEDDED_RESOURCES_HPP
+#define EMBEDDED_RESOURCES_HPP
+
+#include <span>
+#include <string_view>
+
+/**Files which are compiled into the executable, so they can be used without reading from the filesystem.
+ * The build embeds the shaders under their path relative to the repository, for example "shaders/object.vert", and
+ * optionally a font under fontPath. The source file with the data is generated by tools/embedResources.cpp, see the
+ * Makefile for what is embedded.*/
+namespace EmbeddedResources {
+    struct Resource {
+        std::string_view path;
+        std::string_view data;
+    };
+
+    /**The path of the font for TextRenderer, if the build embedded one.*/
+    constexpr std::string_view fontPath = "fonts/embedded.ttf";
+
+    /**@return The resource embedded under path, nullptr if there is none. The data lives as long as the program.*/
+    const Resource* find(const std::string_view path) noexcept;
+
+    namespace Detail {
+        /**Defined in the generated source file.*/
+        extern const std::span<const Resource> resources;
+    }
+}
+
+#endif //EMBEDDED_RESOURCES_HPP
@@ -0,0 +1,22 @@
+#ifndef FNV1A_HPP
+#define FNV1A_HPP
+
+#include <cstdint>
+#include <string_view>
+
+/**The 64 bit FNV-1a hash: simple and fast on short strings, like names and shader sources. Not cryptographic.*/
+namespace Fnv1a {
+    constexpr std::uint64_t offsetBasis = 14695981039346656037ull;
+    constexpr std::uint64_t prime = 1099511628211ull;
+
+    /**@return The hash of data, continued from hash, so several strings can be hashed as one.*/
+    constexpr std::uint64_t hash(const std::string_view data, std::uint64_t hash = offsetBasis) noexcept
+    {
+        for (const char c : data) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * prime;
+        }
+        return hash;
+    }
+}
+
+#endif //FNV1A_HPP
@@ -0,0 +1,130 @@
+#ifndef GLYPH_CACHE_HPP
+#define GLYPH_CACHE_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "glad/glad.h"
+#include "shelfPacker.hpp"
+
+/**The glyphs of one font face, rasterized by libFreeType when they are first drawn and kept in a texture array of
+ * pageCount pages, each pageSize texels square.
+ * Only the glyphs in use take atlas space: when every page is full, the page used least recently is cleared and its
+ * glyphs are rasterized again when they are drawn next. Eviction works on whole pages, because the shelves of a
+ * ShelfPacker cannot free single rectangles. The pages used by the current use, see beginUse, are never evicted; a
+ * glyph that does not fit into the other pages is not drawn.
+ * New glyphs are copied into a copy of their page in memory, and uploaded by flush with one upload per page that
+ * changed, so the first frame of new text uploads once per page instead of once per glyph.
+ * The metrics of every glyph seen are kept, layout never has to rasterize.*/
+class GlyphCache {
+    public:
+        /**A font face and its library, which the GlyphCache takes ownership of.*/
+        struct Font {
+            FT_Library library;
+            FT_Face face;
+        };
+        struct Glyph {
+            /**The index of the glyph in the face, 0 for the missing glyph of the font.*/
+            FT_UInt index;
+            /**In 1/64 pixels.*/
+            float advance;
+            /**Whether the members below are valid. They are known once the glyph was rasterized.*/
+            bool rasterized;
+            unsigned int width;
+            unsigned int rows;
+            FT_Int left;
+            FT_Int top;
+            /**The page the glyph is in, -1 if it is not in any.*/
+            int page;
+            /**The top left corner of the glyph in its page, in texels.*/
+            std::uint16_t x;
+            std::uint16_t y;
+        };
+        struct Statistics {
+            /**The glyphs whose metrics are known.*/
+            std::size_t knownGlyphs;
+            /**The glyphs in the pages.*/
+            std::size_t residentGlyphs;
+            std::size_t pagesInUse;
+            std::size_t pageCount;
+            /**The texels covered by glyphs and their padding, in all pages.*/
+            std::size_t usedTexels;
+            std::size_t totalTexels;
+            std::size_t rasterizations;
+            /**The pages cleared to make room, and the glyphs they held.*/
+            std::size_t pageEvictions;
+            std::size_t glyphEvictions;
+            /**The glyphs that could not be drawn, because they are bigger than a page or every page is in use.*/
+            std::size_t rejections;
+            std::size_t uploads;
+            std::size_t uploadedBytes;
+        };
+        /**The glyph instances store the page and the y coordinate in 16 bits, see TextRenderer::GlyphInstance.*/
+        static constexpr unsigned int maxPageSize = 4096;
+        static constexpr unsigned int maxPageCount = 16;
+    private:
+        struct Page {
+            ShelfPacker packer;
+            /**The contents of the page, pageSize * pageSize bytes, empty until the page is first used.*/
+            std::vector<unsigned char> texels;
+            std::vector<char32_t> glyphs;
+            std::size_t usedTexels;
+            /**The use of beginUse that drew from this page last.*/
+            std::uint64_t lastUse;
+            /**The area changed since the last flush, empty if dirtyLeft >= dirtyRight.*/
+            unsigned int dirtyLeft, dirtyTop, dirtyRight, dirtyBottom;
+        };
+        Font font;
+        unsigned int pageSize;
+        GLuint texture;
+        std::unordered_map<char32_t, Glyph> glyphs;
+        std::vector<Page> pages;
+        std::uint64_t use;
+        std::uint64_t generation;
+        Statistics statistics;
+
+        /**@return The glyph of the code point, added with its metrics if it is new.*/
+        Glyph& lookUp(const char32_t codePoint);
+        /**Rasterize glyph and copy it into a page, evicting one if needed.
+         * @return Whether the glyph is in a page now.*/
+        bool place(const char32_t codePoint, Glyph &glyph);
+        /**@return A page the rectangle was reserved in, -1 if none has room.*/
+        int reserve(const unsigned int width, const unsigned int height, ShelfPacker::Rectangle &rectangle);
+        void evict(Page &page);
+        void markDirty(Page &page, const unsigned int left, const unsigned int top, const unsigned int right,
+                       const unsigned int bottom) noexcept;
+    public:
+        /**@warning Throws std::runtime_error if the page size or count exceeds the limits above, or the OpenGL limits.
+         * The font is released in that case as well.*/
+        GlyphCache(const Font &font, const unsigned int pageSize = 512, const unsigned int pageCount = 4);
+        ~GlyphCache(void);
+
+        GlyphCache(const GlyphCache&) = delete;
+        GlyphCache& operator=(const GlyphCache&) = delete;
+
+        FT_Face getFace(void) const noexcept;
+        /**@return The glyph of the code point, with only the index and advance known if it was never drawn. A glyph
+         * libFreeType fails to load has no advance and is never drawn. The reference stays valid.*/
+        const Glyph& getGlyph(const char32_t codePoint);
+        /**Start a new use, for example the layout of one text: the pages used from now on are not evicted until the
+         * next beginUse.*/
+        void beginUse(void) noexcept;
+        /**Make sure the glyph of the code point is in a page, and mark the page as used.
+         * @return The glyph, nullptr if it has nothing to draw or does not fit.*/
+        const Glyph* acquire(const char32_t codePoint);
+        /**Mark pages as used, bit i for page i, for glyphs laid out earlier.*/
+        void touchPages(const std::uint32_t pageMask) noexcept;
+        /**Upload the glyphs placed since the last flush.*/
+        void flush(void);
+        /**@return The GL_TEXTURE_2D_ARRAY with the pages.*/
+        GLuint getTexture(void) const noexcept;
+        /**@return A number that changes whenever glyphs are evicted, and with them the positions of glyphs laid out
+         * before.*/
+        std::uint64_t getGeneration(void) const noexcept;
+        const Statistics& getStatistics(void) const noexcept;
+};
+
+#endif //GLYPH_CACHE_HPP
@@ -0,0 +1,142 @@
+#ifndef HALF_HPP
+#define HALF_HPP
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+/**A 16 bit IEEE 754 floating point number (1 sign bit, 5 exponent bits, 10 mantissa bits), as used by OpenGL's
+ * GL_HALF_FLOAT. It is a storage type: it converts implicitly to and from float, so all arithmetic happens in float and
+ * is only rounded to half precision when the result is stored. Vector and Matrix of Half therefore also compute in
+ * float.
+ * Conversion from float rounds to nearest, ties to even. Values beyond the half range become infinity, NaN stays NaN.*/
+class Half {
+    private:
+        std::uint16_t bits;
+        static constexpr std::uint16_t fromFloat(const float f) noexcept;
+        static constexpr float toFloat(const std::uint16_t h) noexcept;
+    public:
+        /**Default constructor, initializes to 0.*/
+        constexpr Half(void) noexcept;
+        /**Round f to half precision.*/
+        constexpr Half(const float f) noexcept;
+        /**@return The value as float, which is exact.*/
+        constexpr operator float(void) const noexcept;
+        /**@return The raw 16 bits, as uploaded to OpenGL.*/
+        constexpr std::uint16_t toBits(void) const noexcept;
+        /**@return The Half with the given raw 16 bits.*/
+        static constexpr Half fromBits(const std::uint16_t bits) noexcept;
+
+        constexpr Half& operator+=(const float f) noexcept;
+        constexpr Half& operator-=(const float f) noexcept;
+        constexpr Half& operator*=(const float f) noexcept;
+        constexpr Half& operator/=(const float f) noexcept;
+};
+
+constexpr std::uint16_t Half::fromFloat(const float f) noexcept
+{
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(f);
+    const std::uint32_t sign = (bits >> 16) & 0x8000;
+    const std::uint32_t abs = bits & 0x7fffffff;
+    // Infinity and NaN. Keep the top of the mantissa of a NaN, and make sure it stays a NaN.
+    if (abs >= 0x7f800000)
+        return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 | ((abs >> 13) & 0x3ff) : 0);
+    // Everything from halfway between the largest half (65504) and the next power of two rounds to infinity.
+    if (abs >= 0x477ff000)
+        return sign | 0x7c00;
+    // Below the smallest normal half (2^-14) the result is subnormal: a multiple of 2^-24.
+    if (abs < 0x38800000) {
+        // Up to and including 2^-25, which ties to the even 0.
+        if (abs <= 0x33000000)
+            return sign;
+        const std::uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+        const std::uint32_t shift = 126 - (abs >> 23);
+        std::uint32_t res = mantissa >> shift;
+        const std::uint32_t rest = mantissa & ((1u << shift) - 1);
+        const std::uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (res & 1)))
+            ++res;
+        return sign | res;
+    }
+    // Normal numbers: rebias the exponent from 127 to 15 and round away 13 mantissa bits. A carry out of the mantissa
+    // correctly increments the exponent.
+    const std::uint32_t rebiased = abs - 0x38000000;
+    std::uint32_t res = rebiased >> 13;
+    const std::uint32_t rest = rebiased & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (res & 1)))
+        ++res;
+    return sign | res;
+}
+
+constexpr float Half::toFloat(const std::uint16_t h) noexcept
+{
+    const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000) << 16;
+    const std::uint32_t exponent = (h >> 10) & 0x1f;
+    std::uint32_t mantissa = h & 0x3ff;
+    if (exponent == 0x1f)
+        return std::bit_cast<float>(sign | 0x7f800000 | (mantissa << 13));
+    if (exponent != 0)
+        return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+    if (mantissa == 0)
+        return std::bit_cast<float>(sign);
+    // Subnormal half, normal float: shift the mantissa up until the implicit bit is set.
+    std::uint32_t floatExponent = 113;
+    while (!(mantissa & 0x400)) {
+        mantissa <<= 1;
+        --floatExponent;
+    }
+    return std::bit_cast<float>(sign | (floatExponent << 23) | ((mantissa & 0x3ff) << 13));
+}
+
+constexpr Half::Half(void) noexcept : bits(0)
+{}
+
+constexpr Half::Half(const float f) noexcept : bits(fromFloat(f))
+{}
+
+constexpr Half::operator float(void) const noexcept
+{
+    return toFloat(this->bits);
+}
+
+constexpr std::uint16_t Half::toBits(void) const noexcept
+{
+    return this->bits;
+}
+
+constexpr Half Half::fromBits(const std::uint16_t bits) noexcept
+{
+    Half res;
+    res.bits = bits;
+    return res;
+}
+
+constexpr Half& Half::operator+=(const float f) noexcept
+{
+    *this = Half(static_cast<float>(*this) + f);
+    return *this;
+}
+
+constexpr Half& Half::operator-=(const float f) noexcept
+{
+    *this = Half(static_cast<float>(*this) - f);
+    return *this;
+}
+
+constexpr Half& Half::operator*=(const float f) noexcept
+{
+    *this = Half(static_cast<float>(*this) * f);
+    return *this;
+}
+
+constexpr Half& Half::operator/=(const float f) noexcept
+{
+    *this = Half(static_cast<float>(*this) / f);
+    return *this;
+}
+
+/**The type in which arithmetic on elements of type T happens: T itself, except for Half, which computes in float.*/
+template <typename T>
+using ArithmeticType = decltype(std::declval<T>() + std::declval<T>());
+
+#endif //HALF_HPP
@@ -0,0 +1,57 @@
+#ifndef INSTANCED_RENDERER_HPP
+#define INSTANCED_RENDERER_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "glad/glad.h"
+#include "matrix.hpp"
+#include "openglMatrix.hpp"
+
+/**Draws many copies of one mesh, each with its own model matrix, with a single glDrawArraysInstanced call.
+ * The model matrices are stored in a per-instance vertex buffer, which is attached to the given vertex array object as
+ * three vec4 attributes (glVertexAttribDivisor 1) at modelAttributeLocation and the two locations after it. They are the
+ * rows of the upper 3x4 part of the model matrix, the last row of an affine transformation is always (0, 0, 0, 1). See
+ * the INSTANCED variant of shaders/object.vert for how a vertex shader uses them.
+ * The vertex array object should only be used for instanced drawing, so give every InstancedRenderer its own one, even
+ * if the meshes share vertex buffers. The renderer does not own it.*/
+class InstancedRenderer {
+    private:
+        GLuint vertexArray;
+        GLuint instanceBuffer;
+        GLsizei vertexCount;
+        /**The number of instances instanceBuffer has room for.*/
+        std::size_t capacity;
+        std::size_t instanceCount;
+        /**The matrices as they are stored in instanceBuffer.*/
+        std::vector<Matrix3x4> instances;
+        /**The version of the OpenGlMatrix each instance was last uploaded from, so unchanged instances are skipped.
+         * Versions are unique across all matrices, so an equal version means the same matrix in the same state, even
+         * if another matrix was assigned into the slot. Empty if the instances were set from Matrix4.*/
+        std::vector<std::uint64_t> sourceVersions;
+
+        void reserve(const std::size_t count);
+        void upload(const std::size_t first, const std::size_t count) const;
+    public:
+        /**@param vertexArray A vertex array object with the per-vertex attributes of the mesh already set up.
+         * @param vertexCount The number of vertices to draw per instance, see glDrawArraysInstanced.
+         * @param modelAttributeLocation The first of the three attribute locations used for the model matrix.*/
+        InstancedRenderer(const GLuint vertexArray, const GLsizei vertexCount, const GLuint modelAttributeLocation = 2);
+        ~InstancedRenderer(void);
+
+        InstancedRenderer(const InstancedRenderer&) = delete;
+        InstancedRenderer& operator=(const InstancedRenderer&) = delete;
+
+        /**Use the matrices of models as the instances. Only the instances whose OpenGlMatrix changed since the last call
+         * (see OpenGlMatrix::getVersion) are uploaded again.*/
+        void setInstances(std::span<OpenGlMatrix> models);
+        /**Use models as the instances, they are all uploaded.
+         * @warning Only the upper three rows are used, the last row is assumed to be (0, 0, 0, 1).*/
+        void setInstances(std::span<const Matrix4> models);
+        /**Draw every instance as GL_TRIANGLES, with the shader program in use.*/
+        void draw(void) const;
+        std::size_t getInstanceCount(void) const noexcept;
+};
+
+#endif //INSTANCED_RENDERER_HPP
@@ -0,0 +1,71 @@
+#ifndef LINE_LAYOUT_CACHE_HPP
+#define LINE_LAYOUT_CACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**Remembers how texts were broken into lines, so text which is drawn every frame is not split and measured again.
+ * An entry is identified by the text, the scale and the wrap width. The lines refer to the text by offsets, so an entry
+ * takes little more memory than a copy of the text. The text is compared on a hit, a hash collision cannot return the
+ * lines of another text.
+ * The memory use is bounded: when the entries take more than maxBytes, the least recently used ones are removed.*/
+class LineLayoutCache {
+    public:
+        /**One line of a text.*/
+        struct Line {
+            /**The offset of the first character in the text.*/
+            std::size_t begin;
+            std::size_t length;
+            /**The width in pixels, at the scale of the entry.*/
+            float width;
+        };
+        struct Statistics {
+            std::size_t hits;
+            std::size_t misses;
+            std::size_t evictions;
+            std::size_t entries;
+            /**The approximate memory used by the entries.*/
+            std::size_t bytes;
+        };
+    private:
+        struct Key {
+            std::uint64_t textHash;
+            float scale;
+            float maxLineLength;
+            bool operator==(const Key &other) const = default;
+        };
+        struct KeyHash {
+            std::size_t operator()(const Key &key) const noexcept;
+        };
+        struct Entry {
+            Key key;
+            std::string text;
+            std::vector<Line> lines;
+            std::size_t bytes;
+        };
+        /**The most recently used entry first.*/
+        std::list<Entry> entries;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        std::size_t maxBytes;
+        Statistics statistics;
+
+        static Key getKey(const std::string_view text, const float scale, const float maxLineLength) noexcept;
+    public:
+        explicit LineLayoutCache(const std::size_t maxBytes = 256 * 1024);
+
+        /**@return The lines stored for the text, nullptr if there are none. Valid until the next insert or clear.*/
+        const std::vector<Line>* find(const std::string_view text, const float scale, const float maxLineLength);
+        /**Store the lines of the text, and remove the least recently used entries if the cache is too big. The new
+         * entry is always kept, even if it is bigger than maxBytes on its own.
+         * @return The stored lines, valid until the next insert or clear.*/
+        const std::vector<Line>& insert(const std::string_view text, const float scale, const float maxLineLength,
+                                        std::vector<Line> lines);
+        void clear(void) noexcept;
+        const Statistics& getStatistics(void) const noexcept;
+};
+
+#endif //LINE_LAYOUT_CACHE_HPP
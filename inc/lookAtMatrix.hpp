@@ -0,0 +1,14 @@
+#ifndef LOOK_AT_MATRIX_HPP
+#define LOOK_AT_MATRIX_HPP
+
+#include "matrix.hpp"
+#include "vector.hpp"
+
+/**Create the view matrix of a camera at cameraPos, looking along -cameraDirection.
+ * Kept apart from ViewMatrix, which handles the input, so it can be used (and benchmarked) without a window.
+ * @param worldUp The direction which is up in the world. It may not be parallel to cameraDirection.
+ * @param cameraDirection The normalized direction the camera looks away from.
+ * @param cameraPos The position of the camera in world coordinates.*/
+Matrix4 createLookAtMatrix(const Vector3 &worldUp, const Vector3 &cameraDirection, const Vector3 &cameraPos);
+
+#endif //LOOK_AT_MATRIX_HPP
@@ -0,0 +1,413 @@
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "half.hpp"
+#include "matrix4Kernels.hpp"
+
+/**The order in which the elements of a Matrix are stored.*/
+enum class MatrixLayout {
+    rowMajor,   /**The first element of the second row resides at [C]. Used by the math in this project.*/
+    columnMajor /**The first element of the second column resides at [R]. Used by OpenGL.*/
+};
+
+/**This class represents an R x C matrix with elements of type T (float, double or Half), stored in the given layout,
+ * without any padding. Use the aliases at the bottom of this file, like Matrix4 (row-based), ColumnMajorMatrix4 (the
+ * layout OpenGL expects), Matrix3 for normal matrices and Matrix3x4 for affine transformations.
+ * This class attempts to follow the conventional linear algebra, independent of the layout: only the order of the
+ * elements in data() and operator[] differs. Converting between layouts, element types and sizes is explicit.
+ * A column-based matrix can be uploaded without asking the driver to transpose it, or copied into a uniform or instance
+ * buffer as is.
+ *
+ * Everything is constexpr, so matrices can be built in constant expressions and static tables. For 4x4 float matrices
+ * at runtime, multiplication and inversion use the implementation Matrix4Kernels selects for the CPU, which
+ * the compiler cannot see through: use a constexpr variable to guarantee that a product of known matrices is folded at
+ * compile time. In a constant expression these use the same operations as the scalar reference implementation.*/
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout = MatrixLayout::rowMajor>
+class Matrix {
+    private:
+        /**Whether the kernels in Matrix4Kernels apply to this type.*/
+        static constexpr bool hasKernels = std::is_same_v<T, float> && R == 4 && C == 4;
+        std::array<T, R * C> mat;
+        /**@return The position of the element at row, col in mat.*/
+        static constexpr std::size_t index(const std::size_t row, const std::size_t col) noexcept;
+        /**Inversion by Gauss-Jordan elimination with partial pivoting, for square matrices without a kernel.*/
+        static constexpr Matrix gaussJordanInverse(const Matrix &mat);
+
+        template <typename, std::size_t, std::size_t, MatrixLayout>
+        friend class Matrix;
+    public:
+        using value_type = T;
+        static constexpr std::size_t rows = R;
+        static constexpr std::size_t columns = C;
+
+        /**Default constructor, initializes to the identity matrix. If the matrix is not square, the diagonal elements
+         * are 1 and all others are 0.*/
+        constexpr Matrix(void);
+        /**Constructor from std::array, in the storage order of Layout. Allows intializations like Matrix4 a = {0};*/
+        constexpr Matrix(const std::array<T, R * C> &matrix);
+        /**Convert from another element type, layout and/or size. Elements which do not exist in other are taken from
+         * the identity matrix, so a Matrix3 becomes a Matrix4 with 0, 0, 0, 1 as fourth row and column, and a Matrix4
+         * becomes a Matrix3 by taking its upper-left part.*/
+        template <typename U, std::size_t R2, std::size_t C2, MatrixLayout OtherLayout>
+        explicit constexpr Matrix(const Matrix<U, R2, C2, OtherLayout> &other);
+
+        /**@return The transpose of mat.*/
+        static constexpr Matrix<T, C, R, Layout> transpose(const Matrix &mat);
+        /**@return The inverse of any invertible matrix. 4x4 float matrices use the implementation
+         * Matrix4Kernels selects.
+         * @warning Throws std::runtime_error if mat is singular.*/
+        static constexpr Matrix inverse(const Matrix &mat) requires (R == C);
+        /**@return The inverse of an affine transformation. For a 4x4 matrix the last row must be (0, 0, 0, 1), like the
+         * matrices created by OpenGlMatrix, which is not checked. A 3x4 matrix leaves that row out.
+         * Only the left 3x3 part has to be inverted, which is much cheaper.
+         * @warning Throws std::runtime_error if mat is singular.*/
+        static constexpr Matrix affineInverse(const Matrix &mat) requires (C == 4 && (R == 3 || R == 4));
+        /**@return The inverse of a rigid transformation: a rotation followed by a translation, like the matrices
+         * created by ViewMatrix. The inverse of the rotation is its transpose, so this is cheaper still.
+         * @warning The result is wrong if mat also scales or shears. This is not checked.*/
+        static constexpr Matrix rigidInverse(const Matrix &mat) requires (C == 4 && (R == 3 || R == 4));
+        /**@return The normal matrix belonging to the model matrix: the inverse transpose of its upper-left 3x3 part.
+         * @warning Throws std::runtime_error if that part is singular.*/
+        template <std::size_t R2, std::size_t C2, MatrixLayout OtherLayout>
+        static constexpr Matrix normalMatrix(const Matrix<T, R2, C2, OtherLayout> &model) requires (R == 3 && C == 3);
+
+        /**Multiply each element of the matrix with f.*/
+        constexpr Matrix& operator*=(const ArithmeticType<T> f);
+        /**Multiply two matrices, following conventional linear algebra.*/
+        constexpr Matrix& operator*=(const Matrix<T, C, C, Layout> &other);
+        /**Add the elements of the other matrix to this one.*/
+        constexpr Matrix& operator+=(const Matrix &other);
+        /**Subtract the element of the other matrix from this one.*/
+        constexpr Matrix& operator-=(const Matrix &other);
+        /**Return a pointer to a c-style array containing the current data in this matrix, in the order of Layout.
+         * See also the documentation for std::array::data.*/
+        constexpr const T* data(void) const noexcept;
+        /**@return The value at position i of data().
+         * @warning Asking for i >= R * C causes undefined behaviour.*/
+        constexpr T operator[](const std::size_t i) const;
+        /**@return The value at the given row and column, independent of Layout.
+         * @warning Asking for row >= R or col >= C causes undefined behaviour.*/
+        constexpr T operator()(const std::size_t row, const std::size_t col) const;
+
+        /**@return lhs * rhs, computed with the same operations in the same order as the scalar reference kernels.*/
+        template <std::size_t K>
+        static constexpr Matrix multiplyScalar(const Matrix<T, R, K, Layout> &lhs, const Matrix<T, K, C, Layout> &rhs);
+};
+
+/**A row-based 4x4 float matrix, the type used throughout this project.*/
+using Matrix4 = Matrix<float, 4, 4>;
+/**A column-based 4x4 float matrix, ready for OpenGL.*/
+using ColumnMajorMatrix4 = Matrix<float, 4, 4, MatrixLayout::columnMajor>;
+/**A row-based 3x3 float matrix, mainly for normal matrices.*/
+using Matrix3 = Matrix<float, 3, 3>;
+/**A row-based 3x4 float matrix: an affine transformation without the constant last row. 48 instead of 64 bytes, and
+ * its storage is exactly a GLSL mat3x4 whose columns are the rows, so a shader computes vec4(position, 1) * matrix.*/
+using Matrix3x4 = Matrix<float, 3, 4>;
+/**Double precision variants, for example for positions in large worlds.*/
+using Matrix4d = Matrix<double, 4, 4>;
+using Matrix3d = Matrix<double, 3, 3>;
+using Matrix3x4d = Matrix<double, 3, 4>;
+
+/**Create a new matrix from a multiplication. See Matrix::operator*=.*/
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> operator*(Matrix<T, R, C, Layout> lhs, const ArithmeticType<T> rhs);
+/**Create a new matrix from a multiplication, following conventional linear algebra.*/
+template <typename T, std::size_t R, std::size_t K, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> operator*(const Matrix<T, R, K, Layout> &lhs, const Matrix<T, K, C, Layout> &rhs);
+/**Create a new matrix from an addition. See Matrix::operator+=.*/
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> operator+(Matrix<T, R, C, Layout> lhs, const Matrix<T, R, C, Layout> &rhs);
+/**Create a new matrix from a substraction. See Matrix::operator-=.*/
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> operator-(Matrix<T, R, C, Layout> lhs, const Matrix<T, R, C, Layout> &rhs);
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr std::size_t Matrix<T, R, C, Layout>::index(const std::size_t row, const std::size_t col) noexcept
+{
+    if constexpr (Layout == MatrixLayout::rowMajor) {
+        return row*C + col;
+    } else {
+        return col*R + row;
+    }
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout>::Matrix(void) : mat{}
+{
+    for (std::size_t i = 0; i < R && i < C; ++i) {
+        this->mat[index(i, i)] = 1;
+    }
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout>::Matrix(const std::array<T, R * C> &matrix) : mat(matrix)
+{}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+template <typename U, std::size_t R2, std::size_t C2, MatrixLayout OtherLayout>
+constexpr Matrix<T, R, C, Layout>::Matrix(const Matrix<U, R2, C2, OtherLayout> &other) : Matrix()
+{
+    for (std::size_t row = 0; row < R && row < R2; ++row) {
+        for (std::size_t col = 0; col < C && col < C2; ++col) {
+            this->mat[index(row, col)] = static_cast<T>(other(row, col));
+        }
+    }
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, C, R, Layout> Matrix<T, R, C, Layout>::transpose(const Matrix &mat)
+{
+    Matrix<T, C, R, Layout> res;
+    for (std::size_t row = 0; row < R; ++row) {
+        for (std::size_t col = 0; col < C; ++col) {
+            res.mat[res.index(col, row)] = mat(row, col);
+        }
+    }
+    return res;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> Matrix<T, R, C, Layout>::gaussJordanInverse(const Matrix &mat)
+{
+    using Arithmetic = ArithmeticType<T>;
+    std::array<std::array<Arithmetic, 2 * R>, R> rows = {};
+    for (std::size_t row = 0; row < R; ++row) {
+        for (std::size_t col = 0; col < R; ++col) {
+            rows[row][col] = mat(row, col);
+        }
+        rows[row][R + row] = 1;
+    }
+    for (std::size_t col = 0; col < R; ++col) {
+        std::size_t pivot = col;
+        for (std::size_t row = col + 1; row < R; ++row) {
+            const Arithmetic candidate = rows[row][col] < 0 ? -rows[row][col] : rows[row][col];
+            const Arithmetic best = rows[pivot][col] < 0 ? -rows[pivot][col] : rows[pivot][col];
+            if (candidate > best)
+                pivot = row;
+        }
+        if (rows[pivot][col] == 0)
+            throw std::runtime_error("Matrix is singular and cannot be inverted");
+        std::swap(rows[pivot], rows[col]);
+        const Arithmetic invPivot = 1 / rows[col][col];
+        for (Arithmetic &f : rows[col]) {
+            f *= invPivot;
+        }
+        for (std::size_t row = 0; row < R; ++row) {
+            if (row == col)
+                continue;
+            const Arithmetic factor = rows[row][col];
+            for (std::size_t i = 0; i < 2 * R; ++i) {
+                rows[row][i] -= factor * rows[col][i];
+            }
+        }
+    }
+    Matrix res;
+    for (std::size_t row = 0; row < R; ++row) {
+        for (std::size_t col = 0; col < R; ++col) {
+            res.mat[index(row, col)] = rows[row][R + col];
+        }
+    }
+    return res;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> Matrix<T, R, C, Layout>::inverse(const Matrix &mat) requires (R == C)
+{
+    if constexpr (R == 3) {
+        // The cofactors of the first row double as the terms of the determinant.
+        const ArithmeticType<T> c0 = mat(1, 1) * mat(2, 2) - mat(1, 2) * mat(2, 1);
+        const ArithmeticType<T> c1 = mat(1, 2) * mat(2, 0) - mat(1, 0) * mat(2, 2);
+        const ArithmeticType<T> c2 = mat(1, 0) * mat(2, 1) - mat(1, 1) * mat(2, 0);
+        const ArithmeticType<T> det = mat(0, 0) * c0 + mat(0, 1) * c1 + mat(0, 2) * c2;
+        if (det == 0)
+            throw std::runtime_error("Matrix is singular and cannot be inverted");
+        const ArithmeticType<T> invDet = 1 / det;
+        Matrix res;
+        res.mat[index(0, 0)] = c0 * invDet;
+        res.mat[index(0, 1)] = (mat(0, 2) * mat(2, 1) - mat(0, 1) * mat(2, 2)) * invDet;
+        res.mat[index(0, 2)] = (mat(0, 1) * mat(1, 2) - mat(0, 2) * mat(1, 1)) * invDet;
+        res.mat[index(1, 0)] = c1 * invDet;
+        res.mat[index(1, 1)] = (mat(0, 0) * mat(2, 2) - mat(0, 2) * mat(2, 0)) * invDet;
+        res.mat[index(1, 2)] = (mat(0, 2) * mat(1, 0) - mat(0, 0) * mat(1, 2)) * invDet;
+        res.mat[index(2, 0)] = c2 * invDet;
+        res.mat[index(2, 1)] = (mat(0, 1) * mat(2, 0) - mat(0, 0) * mat(2, 1)) * invDet;
+        res.mat[index(2, 2)] = (mat(0, 0) * mat(1, 1) - mat(0, 1) * mat(1, 0)) * invDet;
+        return res;
+    } else if constexpr (hasKernels) {
+        if (!std::is_constant_evaluated()) {
+            // The kernels work on row-based storage. Column-based storage is the row-based storage of the transpose,
+            // and the inverse of the transpose is the transpose of the inverse, so the same kernel serves both layouts.
+            Matrix res = mat;
+            if (!Matrix4Kernels::inverse(res.mat.data(), res.mat.data()))
+                throw std::runtime_error("Matrix is singular and cannot be inverted");
+            return res;
+        }
+    }
+    return gaussJordanInverse(mat);
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> Matrix<T, R, C, Layout>::affineInverse(const Matrix &mat)
+    requires (C == 4 && (R == 3 || R == 4))
+{
+    // | L t |^-1  is  | L^-1  -L^-1 * t |
+    // | 0 1 |         | 0     1         |
+    const Matrix<T, 3, 3, Layout> linearInverse = Matrix<T, 3, 3, Layout>::inverse(Matrix<T, 3, 3, Layout>(mat));
+    Matrix res;
+    for (std::size_t row = 0; row < 3; ++row) {
+        for (std::size_t col = 0; col < 3; ++col) {
+            res.mat[index(row, col)] = linearInverse(row, col);
+        }
+        res.mat[index(row, 3)] = -(linearInverse(row, 0) * mat(0, 3) + linearInverse(row, 1) * mat(1, 3)
+                                   + linearInverse(row, 2) * mat(2, 3));
+    }
+    return res;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> Matrix<T, R, C, Layout>::rigidInverse(const Matrix &mat)
+    requires (C == 4 && (R == 3 || R == 4))
+{
+    // | R t |^-1  is  | R^T  -R^T * t |
+    // | 0 1 |         | 0    1        |
+    Matrix res;
+    for (std::size_t row = 0; row < 3; ++row) {
+        for (std::size_t col = 0; col < 3; ++col) {
+            res.mat[index(row, col)] = mat(col, row);
+        }
+        res.mat[index(row, 3)] = -(mat(0, row) * mat(0, 3) + mat(1, row) * mat(1, 3) + mat(2, row) * mat(2, 3));
+    }
+    return res;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+template <std::size_t R2, std::size_t C2, MatrixLayout OtherLayout>
+constexpr Matrix<T, R, C, Layout> Matrix<T, R, C, Layout>::normalMatrix(const Matrix<T, R2, C2, OtherLayout> &model)
+    requires (R == 3 && C == 3)
+{
+    return transpose(inverse(Matrix(model)));
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+template <std::size_t K>
+constexpr Matrix<T, R, C, Layout> Matrix<T, R, C, Layout>::multiplyScalar(const Matrix<T, R, K, Layout> &lhs,
+                                                                          const Matrix<T, K, C, Layout> &rhs)
+{
+    Matrix res;
+    for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) {
+            ArithmeticType<T> sum = lhs(i, 0) * rhs(0, j);
+            for (std::size_t k = 1; k < K; ++k) {
+                sum += lhs(i, k) * rhs(k, j);
+            }
+            res.mat[index(i, j)] = sum;
+        }
+    }
+    return res;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout>& Matrix<T, R, C, Layout>::operator*=(const ArithmeticType<T> f)
+{
+    for (std::size_t i = 0; i < this->mat.size(); ++i) {
+        this->mat[i] *= f;
+    }
+    return *this;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout>& Matrix<T, R, C, Layout>::operator*=(const Matrix<T, C, C, Layout> &other)
+{
+    if constexpr (hasKernels) {
+        if (!std::is_constant_evaluated()) {
+            if constexpr (Layout == MatrixLayout::rowMajor) {
+                // The kernels allow the output to alias the input, so no temporary is required.
+                Matrix4Kernels::multiply(this->mat.data(), other.mat.data(), this->mat.data());
+            } else {
+                // Column-based storage is the row-based storage of the transpose, and (A * B)^T = B^T * A^T.
+                Matrix4Kernels::multiply(other.mat.data(), this->mat.data(), this->mat.data());
+            }
+            return *this;
+        }
+    }
+    *this = multiplyScalar(*this, other);
+    return *this;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr T Matrix<T, R, C, Layout>::operator[](const std::size_t i) const
+{
+    return mat[i];
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr T Matrix<T, R, C, Layout>::operator()(const std::size_t row, const std::size_t col) const
+{
+    return mat[index(row, col)];
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout>& Matrix<T, R, C, Layout>::operator+=(const Matrix &other)
+{
+    for (std::size_t i = 0; i < this->mat.size(); ++i) {
+        this->mat[i] += other.mat[i];
+    }
+    return *this;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout>& Matrix<T, R, C, Layout>::operator-=(const Matrix &other)
+{
+    for (std::size_t i = 0; i < this->mat.size(); ++i) {
+        this->mat[i] -= other.mat[i];
+    }
+    return *this;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr const T* Matrix<T, R, C, Layout>::data(void) const noexcept
+{
+    return this->mat.data();
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> operator*(Matrix<T, R, C, Layout> lhs, const ArithmeticType<T> rhs)
+{
+    lhs *= rhs;
+    return lhs;
+}
+
+template <typename T, std::size_t R, std::size_t K, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> operator*(const Matrix<T, R, K, Layout> &lhs, const Matrix<T, K, C, Layout> &rhs)
+{
+    if constexpr (K == C) {
+        // Square right-hand side, so operator*= applies, including the kernels.
+        Matrix<T, R, C, Layout> res = lhs;
+        res *= rhs;
+        return res;
+    } else {
+        return Matrix<T, R, C, Layout>::multiplyScalar(lhs, rhs);
+    }
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> operator+(Matrix<T, R, C, Layout> lhs, const Matrix<T, R, C, Layout> &rhs)
+{
+    lhs += rhs;
+    return lhs;
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Matrix<T, R, C, Layout> operator-(Matrix<T, R, C, Layout> lhs, const Matrix<T, R, C, Layout> &rhs)
+{
+    lhs -= rhs;
+    return lhs;
+}
+
+#endif //MATRIX_HPP
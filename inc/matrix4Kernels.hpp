@@ -0,0 +1,119 @@
+#ifndef MATRIX4_KERNELS_HPP
+#define MATRIX4_KERNELS_HPP
+
+#include <cstddef>
+
+/**Low level kernels for 4x4 float matrices, operating on raw, row-based float[16] storage (see Matrix4).
+ *
+ * Every kernel exists in several implementations: a scalar reference implementation and SSE2, AVX and AVX+FMA
+ * implementations. The widest instruction set supported by the CPU is selected once, using CPUID, the first time
+ * the kernels are used. Afterwards, every call is a single indirect function call.
+ * Wider is not always faster: each set uses the fastest measured kernel its instruction set allows. The 4x4 multiply
+ * does not gain from 256 bit registers, so the AVX and AVX+FMA sets use the SSE2 multiply. The vector and point
+ * transformations do.
+ *
+ * Precision: the scalar, SSE2 and AVX implementations perform exactly the same floating point operations in exactly
+ * the same order, so their results are bit-for-bit identical. So does the 4x4 multiply of the AVX+FMA implementation,
+ * which is the SSE2 one. Its vector and point transformations do not round the intermediate products. Every element
+ * of their result is the dot product of a matrix row and a vector, for which both methods stay within
+ * 4 * 2^-24 * sum(|mat_ik * vec_k|) of the exact result. The two results therefore differ at most
+ * 8 * 2^-24 * sum(|mat_ik * vec_k|), which is at most 8 ULP if the terms of the dot product do not cancel each other.
+ * Matrix inversion is the exception: its implementations use different algorithms and only agree up to rounding.
+ * These guarantees assume the default build flags: flags like -march=native allow the compiler to contract the scalar
+ * code into fused multiply-adds as well.
+ */
+namespace Matrix4Kernels {
+    /**The available implementations, ordered by register width. A wider set is not faster at every kernel, see
+     * above.*/
+    enum class InstructionSet {
+        scalar, /**<Plain C++, the reference implementation.*/
+        sse2,   /**<One row per 128 bit register.*/
+        avx,    /**<The point transformations process two packed points, or eight points of the arrays, per 256 bit
+                 * register.*/
+        avxFma  /**<Like avx, with the vector and point transformations using fused multiply-add.*/
+    };
+
+    /**Computes out = lhs * rhs. out may alias lhs and/or rhs.*/
+    using MatrixMultiplyFunction = void (*)(const float* lhs, const float* rhs, float* out);
+    /**Computes out = mat * vec, where vec and out are 4x1 vectors. out may alias vec.*/
+    using MatrixVectorMultiplyFunction = void (*)(const float* mat, const float* vec, float* out);
+
+    /**Computes out = inverse(mat). out may alias mat.
+     * @return false if mat is singular, in which case out is left unchanged.*/
+    using InverseFunction = bool (*)(const float* mat, float* out);
+    /**Pointers to the x, y, z and w arrays of a set of points stored as structure of arrays.
+     * w may be nullptr, in which case every w is taken to be 1.*/
+    struct ConstPointArrays {
+        const float* x;
+        const float* y;
+        const float* z;
+        const float* w;
+    };
+    /**Pointers to the x, y, z and w arrays of a set of points stored as structure of arrays.
+     * w may be nullptr, in which case the resulting w values are not stored.*/
+    struct PointArrays {
+        float* x;
+        float* y;
+        float* z;
+        float* w;
+    };
+    /**Computes out[i] = mat * in[i] for count points stored as structure of arrays.
+     * Every output array must either be the matching input array or not overlap any input array at all.*/
+    using TransformPointArraysFunction = void (*)(const float* mat, const ConstPointArrays& in, const PointArrays& out,
+                                                  const std::size_t count);
+    /**Computes out[i] = mat * in[i] for count points stored as array of structures: x0, y0, z0, w0, x1, y1, ...
+     * out must either be in or not overlap with in at all.*/
+    using TransformPointsFunction = void (*)(const float* mat, const float* in, float* out, const std::size_t count);
+
+    /**One complete implementation of the kernels.*/
+    struct KernelSet {
+        InstructionSet instructionSet;
+        const char* name;
+        MatrixMultiplyFunction multiply;
+        MatrixVectorMultiplyFunction multiplyVector;
+        InverseFunction inverse;
+        TransformPointArraysFunction transformPointArrays;
+        TransformPointsFunction transformPoints;
+    };
+
+    /**@return true if this CPU (and this build) supports the given implementation. scalar is always supported.*/
+    bool isSupported(const InstructionSet instructionSet) noexcept;
+    /**@return The implementation for the given instruction set.
+     * @warning Throws std::runtime_error if the instruction set is not supported, see isSupported.*/
+    const KernelSet& get(const InstructionSet instructionSet);
+    /**@return The implementation selected at startup: the widest supported one.*/
+    const KernelSet& active(void) noexcept;
+
+    /**See MatrixMultiplyFunction. Uses the active implementation.*/
+    inline void multiply(const float* lhs, const float* rhs, float* out) noexcept
+    {
+        active().multiply(lhs, rhs, out);
+    }
+
+    /**See MatrixVectorMultiplyFunction. Uses the active implementation.*/
+    inline void multiplyVector(const float* mat, const float* vec, float* out) noexcept
+    {
+        active().multiplyVector(mat, vec, out);
+    }
+
+    /**See InverseFunction. Uses the active implementation.*/
+    inline bool inverse(const float* mat, float* out) noexcept
+    {
+        return active().inverse(mat, out);
+    }
+
+    /**See TransformPointArraysFunction. Uses the active implementation.*/
+    inline void transformPointArrays(const float* mat, const ConstPointArrays& in, const PointArrays& out,
+                                     const std::size_t count) noexcept
+    {
+        active().transformPointArrays(mat, in, out, count);
+    }
+
+    /**See TransformPointsFunction. Uses the active implementation.*/
+    inline void transformPoints(const float* mat, const float* in, float* out, const std::size_t count) noexcept
+    {
+        active().transformPoints(mat, in, out, count);
+    }
+}
+
+#endif //MATRIX4_KERNELS_HPP
@@ -1,20 +1,61 @@
 #ifndef OPENGL_MATRIX_HPP
 #define OPENGL_MATRIX_HPP
 
-#include "matrix4.hpp"
-#include "vector3.hpp"
+#include <cstdint>
 
+#include "matrix.hpp"
+#include "vector.hpp"
+#include "quaternion.hpp"
+
+/**A model matrix, built from a translation, a rotation, a scaling and a late rotation (applied before scaling).
+ * The combined matrix is cached: it is only recomputed by data() if a setter was called since the last call. The same
+ * holds for its inverse and the normal matrix, which are computed from the components instead of by a general
+ * inversion.*/
 class OpenGlMatrix {
     private:
+        /**Bit flags, see dirtyComponents.*/
+        enum Component : unsigned {
+            translationComponent = 1 << 0,
+            rotationComponent = 1 << 1,
+            scalingComponent = 1 << 2,
+            lateRotationComponent = 1 << 3
+        };
         Vector3 translation;
-        Vector3 rotation;
+        Quaternion rotation;
         Vector3 scaling;
-        Vector3 lateRotation;
+        Quaternion lateRotation;
+        /**Cache of rotation * scaling * lateRotation, which does not depend on the translation.*/
+        Matrix4 linearMat;
         Matrix4 mat;
-        Matrix4 toRotationMatrix(const Vector3 &vec) const;
-        Matrix4 toTranslationMatrix(const Vector3 &vec) const;
+        /**mat in the layout of OpenGL, kept alongside so uploading never needs a transpose.*/
+        ColumnMajorMatrix4 columnMajorMat;
+        Matrix4 inverseMat;
+        Matrix3 normalMat;
+        /**The components which changed since mat was last computed.*/
+        unsigned dirtyComponents;
+        /**Whether inverseMat and normalMat belong to the current components.*/
+        bool inverseValid;
+        /**A version taken from one counter shared by every OpenGlMatrix, so a version value belongs to exactly one
+         * state of one matrix. Copies and assignments take a new one as well.*/
+        class Version {
+            private:
+                std::uint64_t value;
+                static std::uint64_t next(void) noexcept;
+            public:
+                Version(void) noexcept;
+                Version(const Version&) noexcept;
+                Version& operator=(const Version&) noexcept;
+                void advance(void) noexcept;
+                std::uint64_t get(void) const noexcept;
+        };
+        Version version;
+        void markDirty(const unsigned components);
+        Quaternion toRotation(const float x, const float y, const float z) const;
         Matrix4 toScaleMatrix(const Vector3 &vec) const;
-        Matrix4 getCombinedMatrix(void) const;
+        Matrix4 getCombinedMatrix(void);
+        void update(void) noexcept;
+        Matrix4 getInverseMatrix(void) const;
+        void updateInverse(void);
     public:
         OpenGlMatrix();
         OpenGlMatrix& addTranslate(const float x = 0, const float y = 0, const float z = 0);
@@ -25,7 +66,31 @@ class OpenGlMatrix {
         OpenGlMatrix& setRotate(const float x = 0, const float y = 0, const float z = 0);
         OpenGlMatrix& setScale(const float x = 0, const float y = 0, const float z = 0);
         OpenGlMatrix& setLateRotate(const float x = 0, const float y = 0, const float z = 0);
+        /**Apply rot after the current rotation.*/
+        OpenGlMatrix& addRotate(const Quaternion &rot);
+        /**Apply rot after the current late rotation.*/
+        OpenGlMatrix& addLateRotate(const Quaternion &rot);
+        OpenGlMatrix& setRotate(const Quaternion &rot);
+        OpenGlMatrix& setLateRotate(const Quaternion &rot);
+        /**@return The combined matrix, row based. Only recomputed if something changed since the last call.*/
         const float* data(void) noexcept;
+        /**@return The combined matrix, column based, so it can be uploaded with transpose set to false or copied into a
+         * buffer directly. Only recomputed if something changed since the last call.*/
+        const float* columnMajorData(void) noexcept;
+        /**@return The inverse of the combined matrix, row based. Only recomputed if something changed since the last
+         * call.
+         * @warning Throws std::runtime_error if one of the scale factors is 0.*/
+        const float* inverseData(void);
+        /**@return The normal matrix: the inverse transpose of the upper-left 3x3 part of the combined matrix, row based.
+         * Upload it with ShaderProgram::setUniformMatrix3v to transform normals. Only recomputed if something changed
+         * since the last call.
+         * @warning Throws std::runtime_error if one of the scale factors is 0.*/
+        const float* normalMatrixData(void);
+        /**@return A number which changes every time a setter is called or the matrix is assigned to, so every time
+         * data() might change. It is unique across all matrices: two matrices never share a version, even after one
+         * was destroyed. Consumers can store it to skip re-uploading an unchanged matrix. It is never 0, so 0 can be
+         * used to mean "never uploaded".*/
+        std::uint64_t getVersion(void) const noexcept;
 };
 
 #endif //OPENGL_MATRIX_HPP
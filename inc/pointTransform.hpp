@@ -0,0 +1,40 @@
+#ifndef POINT_TRANSFORM_HPP
+#define POINT_TRANSFORM_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include "matrix.hpp"
+#include "matrix4Kernels.hpp"
+#include "vector.hpp"
+
+/**Batched versions of operator*(const Matrix4&, const Vector4&), for transforming large sets of points by one matrix.
+ * They use the SIMD implementation Matrix4Kernels selects for the CPU and perform no bounds checking.
+ * The results match the single vector version, see the precision remarks in matrix4Kernels.hpp.*/
+
+/**Transform count points, stored as structure of arrays (separate x, y, z and w arrays).
+ * @param in The input arrays. If in.w is nullptr, every w is taken to be 1.
+ * @param out The output arrays. If out.w is nullptr, the resulting w values are not stored.
+ * @warning Every output array must either be the matching input array or not overlap any input array at all.*/
+inline void transformPoints(const Matrix4& mat, const Matrix4Kernels::ConstPointArrays& in,
+                            const Matrix4Kernels::PointArrays& out, const std::size_t count) noexcept
+{
+    Matrix4Kernels::transformPointArrays(mat.data(), in, out, count);
+}
+
+/**Transform count points, stored as array of structures: x0, y0, z0, w0, x1, y1, etcetera.
+ * @warning out must either be equal to in or not overlap with in at all.*/
+inline void transformPoints(const Matrix4& mat, const float* in, float* out, const std::size_t count) noexcept
+{
+    Matrix4Kernels::transformPoints(mat.data(), in, out, count);
+}
+
+/**Transform count Vector4s. See transformPoints(const Matrix4&, const float*, float*, const std::size_t).*/
+inline void transformPoints(const Matrix4& mat, const Vector4* in, Vector4* out, const std::size_t count) noexcept
+{
+    static_assert(std::is_standard_layout_v<Vector4> && sizeof(Vector4) == 4 * sizeof(float),
+                  "Vector4 must be layout compatible with float[4]");
+    Matrix4Kernels::transformPoints(mat.data(), reinterpret_cast<const float*>(in), reinterpret_cast<float*>(out), count);
+}
+
+#endif //POINT_TRANSFORM_HPP
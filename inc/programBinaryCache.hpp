@@ -0,0 +1,55 @@
+#ifndef PROGRAM_BINARY_CACHE_HPP
+#define PROGRAM_BINARY_CACHE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <string_view>
+
+#include "glad/glad.h"
+
+/**A cache of linked shader programs on disk, so they do not have to be compiled again on the next start.
+ * It uses glGetProgramBinary and glProgramBinary (OpenGL 4.1 or ARB_get_program_binary). They are loaded at run time,
+ * so on a driver without them the cache simply stays unused and ShaderProgram compiles from source.
+ * Every program is stored in its own file, named after its key. The key is a hash of the source code (including any
+ * defines) and of the GL vendor, renderer and version strings, so an updated driver or a changed shader never loads
+ * a stale binary. A driver may still reject a binary, then load returns 0 and the program is compiled from source.
+ * @warning Requires a current OpenGL context during construction and use.*/
+class ProgramBinaryCache {
+    private:
+        using GetProgramBinaryFunction = void (*)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+        using ProgramBinaryFunction = void (*)(GLuint, GLenum, const void*, GLsizei);
+        using ProgramParameteriFunction = void (*)(GLuint, GLenum, GLint);
+        // Not in the OpenGL 3.3 headers.
+        static constexpr GLenum programBinaryRetrievableHint = 0x8257;
+        static constexpr GLenum programBinaryLength = 0x8741;
+        static constexpr GLenum numProgramBinaryFormats = 0x87FE;
+
+        std::filesystem::path directory;
+        GetProgramBinaryFunction getProgramBinary;
+        ProgramBinaryFunction programBinary;
+        ProgramParameteriFunction programParameteri;
+        /**The hash of the vendor, renderer and version strings, the start of every key.*/
+        std::uint64_t driverHash;
+
+        std::filesystem::path getPath(const std::uint64_t key) const;
+    public:
+        /**@param directory Where the binaries are stored. Created if it does not exist yet.*/
+        explicit ProgramBinaryCache(const std::filesystem::path &directory);
+
+        /**@return Whether the driver supports program binaries. If not, load always fails and store does nothing.*/
+        bool isAvailable(void) const noexcept;
+        /**@return The key of a program built from sources, which should include everything that affects the
+         * compilation, like defines.*/
+        std::uint64_t getKey(const std::initializer_list<std::string_view> sources) const noexcept;
+        /**Ask the driver to keep the binary of program retrievable. Call it before linking a program to store.*/
+        void prepareForStore(const GLuint program) const;
+        /**@return A new, linked program from the binary stored under key, or 0 if there is none or the driver
+         * rejected it. A rejected binary is removed.*/
+        GLuint load(const std::uint64_t key) const;
+        /**Store the binary of the linked program under key. Failing to write it is not an error, the program will
+         * just be compiled again next time.*/
+        void store(const GLuint program, const std::uint64_t key) const;
+};
+
+#endif //PROGRAM_BINARY_CACHE_HPP
@@ -3,7 +3,7 @@
 
 #include <functional>
 
-#include "matrix4.hpp"
+#include "matrix.hpp"
 #include "glfwWindow.hpp"
 
 /** An abstract class representing a projection matrix, which can be attached to a GlfwWindow.
@@ -15,6 +15,10 @@ class ProjectionMatrix {
         std::function<void(void)> windowSizeUnregisterFunction;
         std::function<void(void)> scrollUnregisterFunction;
         Matrix4 mat;
+        ColumnMajorMatrix4 columnMajorMat;
+
+        /**Set mat, and columnMajorMat to match.*/
+        void setMatrix(const Matrix4 &matrix);
 
         /** Unregister from the GlfwWindow callback (if any). This function performs the necessary checks and is thus always safe.
          */
@@ -57,6 +61,10 @@ class ProjectionMatrix {
          * This is basically a float[16]. See std::array::data() for more details.
          */
         virtual const float* data(void) const noexcept;
+        /**Get a pointer to the projection matrix, column based, so it can be uploaded without a transpose.*/
+        virtual const float* columnMajorData(void) const noexcept;
+        /**@return The projection matrix.*/
+        const Matrix4& getMatrix(void) const noexcept;
         /** Register with given GlfwWindow.
          * This function will unregister first, if applicable.
          */
@@ -0,0 +1,71 @@
+#ifndef QUATERNION_HPP
+#define QUATERNION_HPP
+
+#include <cstddef>
+
+#include "matrix.hpp"
+#include "vector.hpp"
+
+/**Represents a rotation as a quaternion w + xi + yj + zk, of type float.
+ * Only unit quaternions represent rotations. All functions which create a quaternion from angles create a unit
+ * quaternion, and composing unit quaternions keeps them (almost) unit: call normalize once in a while when
+ * accumulating many rotations.
+ * Composition follows the matrix conventions: (a * b).toMatrix4() == a.toMatrix4() * b.toMatrix4(), so b is applied
+ * first.*/
+class Quaternion {
+    private:
+        float qw, qx, qy, qz;
+        /**fromEulerAngles, given the cosines and sines of the halves of the angles.*/
+        static Quaternion fromHalfAngles(const float cx, const float sx, const float cy, const float sy, const float cz,
+                                         const float sz);
+    public:
+        /**Construct a Quaternion from its four elements. Also serves as the default constructor, which creates the
+         * identity rotation.*/
+        Quaternion(const float w = 1, const float x = 0, const float y = 0, const float z = 0);
+
+        /**Create a rotation of angle radians around axis. The axis does not need to be normalized.*/
+        static Quaternion fromAxisAngle(const Vector3 &axis, const float angle);
+        /**Create a rotation which first rotates x radians around the x-axis, then y radians around the y-axis and then
+         * z radians around the z-axis.*/
+        static Quaternion fromEulerAngles(const float x, const float y, const float z);
+        /**Batched fromEulerAngles: out[i] = fromEulerAngles(x[i], y[i], z[i]) for i < count. The sines and cosines are
+         * computed in batches, see Trig::sinCos.*/
+        static void fromEulerAngles(const float* x, const float* y, const float* z, Quaternion* out,
+                                    const std::size_t count);
+        /**Spherical linear interpolation between two rotations, always along the shortest path.
+         * @param t 0 returns from, 1 returns to.*/
+        static Quaternion slerp(const Quaternion &from, const Quaternion &to, const float t);
+        /**Batched slerp: out[i] = slerp(from[i], to[i], t[i]) for i < count. out may be equal to from or to.*/
+        static void slerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out,
+                          const std::size_t count);
+        /**Batched slerp with one interpolation factor: out[i] = slerp(from[i], to[i], t) for i < count.*/
+        static void slerp(const Quaternion* from, const Quaternion* to, const float t, Quaternion* out,
+                          const std::size_t count);
+        /**Normalize the quaternion, so it represents a rotation again after accumulating rounding errors.*/
+        static Quaternion normalize(Quaternion quat);
+        /**@return The conjugate, which is the inverse rotation for unit quaternions.*/
+        static Quaternion conjugate(const Quaternion &quat);
+        /**@return The dot product of the quaternions as 4-vectors.*/
+        static float dot(const Quaternion &lhs, const Quaternion &rhs);
+
+        /**@return The rotation matrix. This quaternion is assumed to be a unit quaternion.*/
+        Matrix4 toMatrix4(void) const;
+        /**Rotate the given vector by this rotation.*/
+        Vector3 rotate(const Vector3 &vec) const;
+
+        /**@return The real part.*/
+        float w() const;
+        /**@return The i part.*/
+        float x() const;
+        /**@return The j part.*/
+        float y() const;
+        /**@return The k part.*/
+        float z() const;
+
+        /**Compose this rotation with other: the result first applies other, then this. See the class documentation.*/
+        Quaternion& operator*=(const Quaternion &other);
+};
+/**Create a new Quaternion from a composition. See Quaternion::operator*=.*/
+Quaternion operator*(Quaternion lhs, const Quaternion &rhs);
+
+#endif //QUATERNION_HPP
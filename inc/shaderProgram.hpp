@@ -1,18 +1,80 @@
 #ifndef SHADER_PROGRAM_HPP
 #define SHADER_PROGRAM_HPP
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "glad/glad.h"
-#include "vector4.hpp"
+#include "vector.hpp"
+#include "uniformTable.hpp"
+#include "uniformHandle.hpp"
+#include "programBinaryCache.hpp"
 
+/**A linked vertex and fragment shader.
+ *
+ * Shader files which were embedded into the executable (see EmbeddedResources) are taken from there, they are only
+ * read from the filesystem otherwise. They are run through a small preprocessor before they are compiled:
+ * - #include "file" inserts another file, found relative to the directory of the including file. Every file is
+ *   included at most once per shader, so include files need no guards.
+ * - The Defines passed to the constructor (or to ShaderRegistry) are inserted as #define lines after the #version line.
+ *   The same files can thereby be compiled into variants, selected with #ifdef in the shader.
+ * Conditionals are left to the compiler, so an #include inside #ifdef is inserted either way.
+ * The preprocessor inserts #line directives, so the line numbers of compiler errors refer to the files. The source
+ * string number of an error is the index of the file in the list which is appended to the error message.*/
 class ShaderProgram {
+    public:
+        /**A macro which is defined for a shader variant.*/
+        struct Define {
+            std::string name;
+            /**Empty for a macro which is only checked with #ifdef.*/
+            std::string value;
+        };
+        using Defines = std::vector<Define>;
     private:
+        /**The preprocessed code of a shader.*/
+        struct Source {
+            std::string code;
+            /**The file and everything it includes, indexed by their source string number.*/
+            std::vector<std::string> files;
+        };
+
         GLuint shaderProgram;
-        std::string getCompilationError(GLuint shader);
-        std::string getLinkingError(GLuint shaderProgram);
-        GLint getUniformLocation(const std::string &name) const;
+        /**The active uniforms, reflected once after linking.*/
+        UniformTable uniforms;
+        static std::string getCompilationError(GLuint shader);
+        static std::string getLinkingError(GLuint shaderProgram);
+        /**@return The embedded file with the given path, or the file read from the filesystem if there is none.*/
+        static std::string readSource(const std::string &path);
+        /**@return The file after processing the #include directives and inserting the defines.
+         * @warning Throws std::runtime_error if a file cannot be read, or an #include directive is malformed.*/
+        static Source preprocess(const std::string &path, const Defines &defines);
+        static void appendSource(const std::string &path, Source &source, const Defines *defines);
+        /**@return The error message for a shader which failed to compile from source.*/
+        static std::string describeCompilationError(const GLenum type, const GLuint shader,
+                                                    const std::vector<std::string> &files);
+        static GLuint compileShader(const GLenum type, const Source &source);
+        /**@return A new program, linked from the shaders, which are detached again but not deleted.*/
+        static GLuint linkProgram(const GLuint vertexShader, const GLuint fragmentShader,
+                                  const ProgramBinaryCache *binaryCache);
+        /**Set up the Camera block binding and the uniform table of the linked shaderProgram.*/
+        void initialize(void);
+        /**Take ownership of a linked program.*/
+        explicit ShaderProgram(const GLuint linkedProgram);
+        /**ShaderRegistry compiles and links programs from its cached shaders.*/
+        friend class ShaderRegistry;
+        /**@warning Throws std::runtime_error if the program has no active uniform called name.*/
+        const UniformTable::Uniform& findUniform(const std::string_view name) const;
+        [[noreturn]] void throwTypeMismatch(const UniformTable::Uniform &uniform) const;
 
     public:
-        ShaderProgram(const std::string &vertexShaderPath, const std::string &fragmentShaderPath);
+        /**Compile and link a program from a vertex and a fragment shader file.
+         * @param defines Macros defined in both shaders, see the class documentation.
+         * @param binaryCache If not nullptr, the linked program is loaded from it if possible, and stored in it
+         * otherwise. Compiling from source is the fallback, whatever goes wrong with the cache.
+         * @warning Throws std::runtime_error if a file cannot be read, or compiling or linking fails.*/
+        ShaderProgram(const std::string &vertexShaderPath, const std::string &fragmentShaderPath,
+                      const ProgramBinaryCache *binaryCache = nullptr, const Defines &defines = {});
         ~ShaderProgram();
         // Delete the copy constructor and assignment operator, you should not copy this class
         ShaderProgram(const ShaderProgram&) = delete;
@@ -22,10 +84,29 @@ class ShaderProgram {
         ShaderProgram& operator=(ShaderProgram&&);
 
         void use(void) const;
-        void setUniformMatrix4v(const std::string &name, const size_t count, const bool transpose, const float* value) const;
-        void setUniform3f(const std::string &name, const float v0, const float v1, const float v2) const;
-        void setUniform3f(const std::string &name, const Vector4 &vec) const;
-        void setUniform1i(const std::string &name, const GLint v0) const;
+        /**@return A handle to set the uniform called name, without looking it up again. Prefer it over the setters
+         * below for uniforms which are set often.
+         * @warning Throws std::runtime_error if the program has no active uniform called name, or if its type in the
+         * shader does not match T.*/
+        template <typename T>
+        UniformHandle<T> getUniform(const std::string_view name) const;
+        /**@return Whether the program has an active uniform called name.*/
+        bool hasUniform(const std::string_view name) const noexcept;
+        // The setters look the uniform up by name, and throw std::runtime_error if it does not exist.
+        void setUniformMatrix4v(const std::string_view name, const size_t count, const bool transpose, const float* value) const;
+        void setUniformMatrix3v(const std::string_view name, const size_t count, const bool transpose, const float* value) const;
+        void setUniform3f(const std::string_view name, const float v0, const float v1, const float v2) const;
+        void setUniform3f(const std::string_view name, const Vector3 &vec) const;
+        void setUniform1i(const std::string_view name, const GLint v0) const;
 };
 
+template <typename T>
+UniformHandle<T> ShaderProgram::getUniform(const std::string_view name) const
+{
+    const UniformTable::Uniform &uniform = findUniform(name);
+    if (!UniformTraits<T>::accepts(uniform.type))
+        throwTypeMismatch(uniform);
+    return UniformHandle<T>(uniform.location, uniform.size);
+}
+
 #endif //SHADER_PROGRAM_HPP
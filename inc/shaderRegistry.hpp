@@ -0,0 +1,146 @@
+#ifndef SHADER_REGISTRY_HPP
+#define SHADER_REGISTRY_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "glad/glad.h"
+#include "programBinaryCache.hpp"
+#include "shaderProgram.hpp"
+
+/**Hands out shader programs, sharing everything that was built before: a program made of the same shaders exists only
+ * once, and a shader used by several programs is compiled only once.
+ * Shaders are identified by their type and contents, so the same file reached through different paths, or a copy of
+ * it, is still compiled once. Files which are not embedded into the executable are read on every request, so a changed
+ * file is compiled again.
+ * Programs are shared through std::shared_ptr. The registry keeps a std::weak_ptr, so a program is deleted once nothing
+ * uses it anymore. The compiled shaders are kept until the registry is destroyed.
+ * Variants of the same files (see ShaderProgram::Defines) are shaders with different contents after preprocessing, so
+ * each variant is compiled when it is first requested, and shared from then on. Variants nobody requests are never
+ * compiled.
+ *
+ * Programs can be built in two steps, so the driver can compile them while the application does something else:
+ * requestProgram submits all the work without waiting for a result, getProgram waits for it and checks for errors.
+ * Request every program first, and get them afterwards. With GL_KHR_parallel_shader_compile the driver compiles on
+ * background threads, and isReady tells whether a program can be taken without waiting, to keep drawing a loading
+ * screen in the meantime. Without it, the driver may still defer the work until the first result is queried.
+ *
+ * The registry records how long every program took to build, see getStatistics.
+ * @warning Use one registry per OpenGL context, and destroy it while the context exists.*/
+class ShaderRegistry {
+    public:
+        /**How a program was built.*/
+        struct ProgramStatistics {
+            std::string vertexShaderPath;
+            std::string fragmentShaderPath;
+            ShaderProgram::Defines defines;
+            /**Time spent in the calls which compile the shaders. If the driver compiles in the background, this is
+             * only the time it took to submit them.*/
+            std::chrono::nanoseconds compileTime;
+            /**Time from submitting the link until the program was known to be linked, or the time spent loading it
+             * from the ProgramBinaryCache.*/
+            std::chrono::nanoseconds linkTime;
+            /**The number of shaders (0, 1 or 2) which had to be compiled for this program.*/
+            unsigned compiledShaders;
+            bool loadedFromBinaryCache;
+        };
+    private:
+        /**The key of a shader: a hash of its type and preprocessed contents.*/
+        using ShaderKey = std::uint64_t;
+        using ProgramKey = std::pair<ShaderKey, ShaderKey>;
+        using GlMaxShaderCompilerThreadsFunction = void (*)(GLuint);
+        // From GL_KHR_parallel_shader_compile, not in the OpenGL 3.3 headers.
+        static constexpr GLenum completionStatus = 0x91B1;
+
+        struct Shader {
+            GLuint shader;
+            GLenum type;
+            /**The files it was compiled from, for error messages.*/
+            std::vector<std::string> files;
+            /**Whether the compile status was checked, and was fine.*/
+            bool checked;
+            /**Whether it failed to compile. A failed shader is kept, so every program using it fails with error.*/
+            bool failed;
+            std::string error;
+        };
+        /**A program which was submitted, but not checked yet.*/
+        struct PendingProgram {
+            ProgramKey key;
+            std::uint64_t cacheKey;
+            GLuint program;
+            ProgramStatistics stats;
+            std::chrono::steady_clock::time_point linkStart;
+            /**Set once the program is finished.*/
+            std::shared_ptr<const ShaderProgram> result;
+            /**Set if finishing it failed, getProgram throws it again. The program is deleted then.*/
+            std::string error;
+
+            /**Deletes the program if it was never finished, because every request for it was dropped first.*/
+            ~PendingProgram(void);
+        };
+
+        const ProgramBinaryCache *binaryCache;
+        bool parallelCompile;
+        std::unordered_map<ShaderKey, Shader> shaders;
+        std::map<ProgramKey, std::weak_ptr<const ShaderProgram>> programs;
+        /**Entries whose requests were all dropped expire, and are removed by the next requestProgram.*/
+        std::map<ProgramKey, std::weak_ptr<PendingProgram>> pendingPrograms;
+        std::vector<ProgramStatistics> statistics;
+
+        static ShaderKey getShaderKey(const GLenum type, const std::string &source) noexcept;
+        static bool hasExtension(const std::string &name);
+        /**@return The shader with the given key, submitting it for compilation first if needed.*/
+        GLuint submitShader(const ShaderKey key, const GLenum type, const ShaderProgram::Source &source,
+                            ProgramStatistics &stats);
+        /**Throw std::runtime_error if the shader with the given key failed to compile.*/
+        void checkShader(const ShaderKey key);
+        void finish(PendingProgram &pending);
+    public:
+        /**A program being built, see requestProgram.*/
+        class ProgramRequest {
+            private:
+                friend class ShaderRegistry;
+                std::shared_ptr<PendingProgram> pending;
+                explicit ProgramRequest(std::shared_ptr<PendingProgram> pending);
+        };
+
+        /**@param binaryCache If not nullptr, programs are loaded from and stored in it, see ShaderProgram.*/
+        explicit ShaderRegistry(const ProgramBinaryCache *binaryCache = nullptr);
+        ~ShaderRegistry(void);
+
+        ShaderRegistry(const ShaderRegistry&) = delete;
+        ShaderRegistry& operator=(const ShaderRegistry&) = delete;
+
+        /**Start building the program linked from the vertex and fragment shader files, unless a matching one exists
+         * or is being built. Does not wait for the driver.
+         * @param defines Macros defined in both shaders, see ShaderProgram.
+         * @warning Throws std::runtime_error if a file cannot be read, or cannot be preprocessed.*/
+        ProgramRequest requestProgram(const std::string &vertexShaderPath, const std::string &fragmentShaderPath,
+                                      const ShaderProgram::Defines &defines = {});
+        /**@return Whether getProgram can return the program without waiting. Without GL_KHR_parallel_shader_compile
+         * the driver cannot tell, and this is always true.*/
+        bool isReady(const ProgramRequest &request) const;
+        /**@return The requested program, after waiting for the driver to finish it.
+         * @warning Throws std::runtime_error if compiling or linking failed, again on every call for that request.*/
+        std::shared_ptr<const ShaderProgram> getProgram(const ProgramRequest &request);
+        /**Request the program and wait for it, see requestProgram and getProgram.*/
+        std::shared_ptr<const ShaderProgram> getProgram(const std::string &vertexShaderPath,
+                                                        const std::string &fragmentShaderPath,
+                                                        const ShaderProgram::Defines &defines = {});
+        /**@return Whether the driver compiles in background threads (GL_KHR_parallel_shader_compile).*/
+        bool hasParallelCompile(void) const noexcept;
+        /**@return One entry for every program that was built, in the order they were finished. Programs shared by a
+         * later request are not listed again.*/
+        const std::vector<ProgramStatistics>& getStatistics(void) const noexcept;
+        /**Write the statistics as a table.*/
+        void writeStatistics(std::ostream &out) const;
+};
+
+#endif //SHADER_REGISTRY_HPP
@@ -0,0 +1,42 @@
+#ifndef SHELF_PACKER_HPP
+#define SHELF_PACKER_HPP
+
+#include <optional>
+#include <vector>
+
+/**Packs rectangles into an area of fixed size, for example glyphs into a texture atlas.
+ * The rectangles are placed next to each other in rows, the shelves. A rectangle goes into the lowest shelf that fits
+ * it best, or a new shelf below the others if none does. This wastes little space when the rectangles have similar
+ * heights, as glyphs of one font do, and is fastest if they are inserted from high to low.
+ * Every rectangle is surrounded by padding empty pixels, so texture filtering does not mix neighbours.*/
+class ShelfPacker {
+    public:
+        struct Rectangle {
+            unsigned x;
+            unsigned y;
+            unsigned width;
+            unsigned height;
+        };
+    private:
+        struct Shelf {
+            unsigned y;
+            unsigned height;
+            /**The x coordinate where the next rectangle in this shelf starts.*/
+            unsigned end;
+        };
+        unsigned width;
+        unsigned height;
+        unsigned padding;
+        std::vector<Shelf> shelves;
+    public:
+        ShelfPacker(const unsigned width, const unsigned height, const unsigned padding = 1);
+
+        /**@return Where the rectangle was placed, std::nullopt if there is no room left for it.*/
+        std::optional<Rectangle> insert(const unsigned rectangleWidth, const unsigned rectangleHeight);
+        /**Remove every rectangle.*/
+        void clear(void) noexcept;
+        unsigned getWidth(void) const noexcept;
+        unsigned getHeight(void) const noexcept;
+};
+
+#endif //SHELF_PACKER_HPP
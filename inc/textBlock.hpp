@@ -0,0 +1,59 @@
+#ifndef TEXT_BLOCK_HPP
+#define TEXT_BLOCK_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "glad/glad.h"
+#include "textRenderer.hpp"
+#include "vector.hpp"
+
+/**Text that is laid out and uploaded once, and then drawn as often as needed, for labels which rarely change.
+ * setText takes the same arguments as TextRenderer::renderText, except for the position, and only lays the text out
+ * again if one of them changed. The position is given to draw, so moving the text is free as well. Drawing takes one
+ * draw call for the glyphs and one for the backgrounds, and no uploads unless the glyph cache of the TextRenderer
+ * evicted glyphs in the meantime.
+ * A TextBlock owns its buffers, and uses the font and the shaders of the TextRenderer it was created with, which must
+ * outlive it.*/
+class TextBlock {
+    private:
+        const TextRenderer *renderer;
+        GLuint glyphBuffer, glyphArray, backgroundBuffer, backgroundArray;
+        std::size_t glyphCount, backgroundVertexCount;
+        /**The pages of the glyph cache the glyphs are in, see TextRenderer::TextLayout.*/
+        std::uint32_t pages;
+        /**The generation of the glyph cache the glyphs were laid out in.*/
+        std::uint64_t glyphCacheGeneration;
+        std::string text;
+        float scale;
+        float maxLineLenPix;
+        TextRenderer::VerticalAlignment vAlign;
+        TextRenderer::HorizontalAlignment hAlign;
+        Vector3 textColor;
+        bool addBackgroundColor;
+        Vector3 backgroundColor;
+        /**Whether setText was called at all.*/
+        bool hasText;
+
+        /**Lay the text out and upload it.*/
+        void layOut(void);
+    public:
+        explicit TextBlock(const TextRenderer &renderer);
+        ~TextBlock(void);
+
+        TextBlock(const TextBlock&) = delete;
+        TextBlock& operator=(const TextBlock&) = delete;
+
+        /**Set the text to draw, see TextRenderer::renderText for the arguments.
+         * @return Whether the text had to be laid out and uploaded again.*/
+        bool setText(const std::string &text, const float scale, const float maxLineLenPix = 0,
+                     const TextRenderer::VerticalAlignment vAlign = TextRenderer::VerticalAlignment::top,
+                     const TextRenderer::HorizontalAlignment hAlign = TextRenderer::HorizontalAlignment::left,
+                     const Vector3& textColor = Vector3(1, 1, 1),
+                     const bool addBackgroundColor = false, const Vector3& backgroundColor = Vector3(0, 0, 0));
+        /**Draw the text at (x, y), which is interpreted as in TextRenderer::renderText. Lays the text out again if the
+         * glyph cache evicted glyphs since it was laid out.*/
+        void draw(const float x, const float y);
+};
+
+#endif //TEXT_BLOCK_HPP
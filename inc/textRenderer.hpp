@@ -1,41 +1,27 @@
+#ifndef TEXT_RENDERER_HPP
+#define TEXT_RENDERER_HPP
+
 #include <string>
+#include <string_view>
 #include <array>
+#include <cstdint>
+#include <vector>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include "glyphCache.hpp"
+#include "lineLayoutCache.hpp"
 #include "shaderProgram.hpp"
-#include "vector3.hpp"
-#include "projectionMatrix.hpp"
+#include "shaderRegistry.hpp"
+#include "vector.hpp"
 
-/**The TextRenderer uses libFontConfig and libFreeType to load the first 128 characters of the ASCII table into textures.
+/**The TextRenderer uses libFontConfig and libFreeType to draw UTF-8 text. The glyphs are rasterized when they are first
+ * drawn, into the pages of a GlyphCache, so any code point of the font can be drawn without rasterizing all of them.
+ * If the build embedded a font (see EmbeddedResources), it is used without asking libFontConfig when no font hint is
+ * given, and as a fallback when libFontConfig finds no font.
  * You can then use this object to render text to given coordinates on the screen.
- * This object allocates OpenGL textures, an OpenGL shader and an OpenGL VBO to aid rendering.*/
+ * This object allocates an OpenGL texture array, an OpenGL shader and an OpenGL VBO to aid rendering.*/
 class TextRenderer {
-    private:
-        struct Character {
-            struct Size {
-                unsigned int width;
-                unsigned int rows;
-            };
-            Size size;
-            struct Bearing {
-                FT_Int left;
-                FT_Int top;
-            };
-            Bearing bearing;
-            float advance;
-        };
-
-        std::array<struct Character, 128> characters;
-        std::array<GLuint, 128> textures;
-        GLuint textVBO, textVAO, bgVBO, bgVAO;
-        ShaderProgram textShader, backgroundShader;
-        float lineSpacing64thsPixel, descender64thsPixel;
-
-        std::vector<std::string> splitString(const std::string& str, const float maxLineLenPix, const float scale) const;
-        void renderTextLine(const std::string& line, float x, float y, const float scale) const;
-        float getLineLengthPixels(const std::string& line, const float scale) const;
-        void renderBackground(const float y, const float x, const float height, const float length) const;
     public:
         /**Specifies how the y coordinate is interpeted.*/
         enum class VerticalAlignment {
@@ -50,20 +36,124 @@ class TextRenderer {
             right       /**The x-line is the end of every line.*/
         };
 
-        /**Default constructor
+        /**What renderText and the TextBlocks did since the last resetDrawStatistics.*/
+        struct DrawStatistics {
+            std::size_t drawCalls;
+            std::size_t bufferUploads;
+            std::size_t glyphs;
+        };
+    private:
+        /**One glyph as drawn by shaders/text.vert, which makes a quad of it. 20 bytes instead of the 96 of six vertices
+         * with a position and texture coordinates each.*/
+        struct GlyphInstance {
+            /**The bottom left corner of the quad, in pixels.*/
+            float x;
+            float y;
+            /**The glyph in the glyph cache, in texels. The size of the quad is the size in the page times the scale.
+             * atlasY holds the y coordinate in its lower pageShift bits, and the page above them.*/
+            std::uint16_t atlasX;
+            std::uint16_t atlasY;
+            std::uint16_t width;
+            std::uint16_t height;
+            /**RGBA*/
+            std::array<std::uint8_t, 4> color;
+        };
+        static_assert(sizeof(GlyphInstance) == 20);
+        /**Must match shaders/text.vert.*/
+        static constexpr unsigned int pageShift = 12;
+        static_assert(GlyphCache::maxPageSize <= 1u << pageShift && GlyphCache::maxPageCount <= 1u << (16 - pageShift));
+
+        GLuint textVBO, textVAO, bgVBO, bgVAO;
+        std::shared_ptr<const ShaderProgram> textShader, backgroundShader;
+        UniformHandle<GLfloat> scaleUniform;
+        UniformHandle<Vector2> textOffsetUniform, backgroundOffsetUniform;
+        UniformHandle<Vector3> backgroundColorUniform;
+        /**Rasterizes the glyphs when they are first drawn.*/
+        mutable GlyphCache glyphCache;
+        float lineSpacing64thsPixel, descender64thsPixel;
+
+        /**Text laid out around (0, 0), ready to be uploaded.*/
+        struct TextLayout {
+            std::vector<GlyphInstance> glyphs;
+            /**Two triangles per line, with a x,y coordinate per vertex.*/
+            std::vector<float> backgroundVertices;
+            /**The pages of the glyph cache the glyphs are in, bit i for page i.*/
+            std::uint32_t pages;
+        };
+        /**What renderText lays out, kept to reuse the memory.*/
+        mutable TextLayout scratchLayout;
+        mutable DrawStatistics statistics{};
+
+        /**The line breaks of the texts laid out recently.*/
+        mutable LineLayoutCache lineLayoutCache;
+
+        /**@return The advance of the code point, in pixels at scale 1.*/
+        float getAdvance(const char32_t codePoint) const;
+        /**@return The lines of str: split at newlines, and wrapped at maxLineLenPix unless that is 0. The lines are
+         * given in bytes, but never split a UTF-8 sequence.*/
+        std::vector<LineLayoutCache::Line> splitString(const std::string_view str, const float maxLineLenPix,
+                                                       const float scale) const;
+        /**Add the glyphs of line to layout.*/
+        void appendTextLine(const std::string_view line, float x, float y, const float scale,
+                            const std::array<std::uint8_t, 4> &color, TextLayout &layout) const;
+        float getLineLengthPixels(const std::string_view line, const float scale) const;
+        /**Add a background quad to layout.*/
+        void appendBackground(const float y, const float x, const float height, const float length,
+                              TextLayout &layout) const;
+        /**Lay text out as renderText would draw it at (0, 0), and rasterize the glyphs it needs.*/
+        void layoutText(const std::string &text, const float scale, const float maxLineLenPix,
+                        const VerticalAlignment vAlign, const HorizontalAlignment hAlign, const Vector3& textColor,
+                        const bool addBackgroundColor, TextLayout &layout) const;
+        /**Set up the attributes of a vertex array to draw glyph instances from buffer.*/
+        static void setUpGlyphArray(const GLuint vertexArray, const GLuint buffer);
+        /**Set up the attributes of a vertex array to draw background vertices from buffer.*/
+        static void setUpBackgroundArray(const GLuint vertexArray, const GLuint buffer);
+        /**Replace the contents of the buffers with the layout.*/
+        void upload(const GLuint glyphBuffer, const GLuint backgroundBuffer, const TextLayout &layout,
+                    const GLenum usage) const;
+        /**Draw uploaded text, moved by offset. One draw call for the backgrounds and one for the glyphs, after uploading
+         * the glyphs rasterized since the last draw.
+         * @param pages The pages of the glyph cache the text uses, see TextLayout.*/
+        void draw(const GLuint glyphArray, const std::size_t glyphCount, const GLuint backgroundArray,
+                  const std::size_t backgroundVertexCount, const std::uint32_t pages, const Vector2 &offset,
+                  const float scale, const Vector3 &backgroundColor) const;
+        /**TextBlock lays out and draws its text with the functions above.*/
+        friend class TextBlock;
+        /**@return The file of the font libFontConfig matches to fontHint, empty if it finds none.
+         * @warning Throws std::runtime_error if libFontConfig fails.*/
+        static std::string findFontFile(const std::string &fontHint);
+        /**Load the font of the fontHint at the given pixel size, see the constructor.
+         * @warning Throws std::runtime_error if no font is found, or libFreeType fails to load it.*/
+        static GlyphCache::Font openFont(const std::string &fontHint, const unsigned int pixelWidthHint,
+                                         const unsigned int pixelHeightHint);
+    public:
+        /**Constructor
+         * @param shaderRegistry Provides the shader programs, which are shared by all TextRenderers.
          * @param fontHint Can be almost anything, is passed to libFontConfig, who will attempt to match it to a font.
+         * Leave it empty to use the embedded font, or the default font of libFontConfig if none was embedded.
          * @param pixelWidthHint Is passed to libFreeType, see FT_Set_Pixel_Sizes.
          * @param pixelHeightHint Is passed to libFreeType, see FT_Set_Pixel_Sizes.
          */
-        TextRenderer(const std::string &fontHint = "serif", const unsigned int pixelWidthHint = 0, const unsigned int pixelHeightHint = 48);
+        TextRenderer(ShaderRegistry &shaderRegistry, const std::string &fontHint = "", const unsigned int pixelWidthHint = 0,
+                     const unsigned int pixelHeightHint = 48);
         ~TextRenderer(void);
 
         TextRenderer(const TextRenderer&) = delete;
         TextRenderer& operator=(const TextRenderer&) = delete;
 
-        void renderText(const ProjectionMatrix& mat, const std::string &text, float x, float y, const float scale, const float maxLineLenPix = 0,
+        /**Render text with the overlay projection of the CameraUniformBuffer. Takes at most two draw calls, one for the
+         * backgrounds of all lines and one for all glyphs.*/
+        void renderText(const std::string &text, float x, float y, const float scale, const float maxLineLenPix = 0,
                         const VerticalAlignment vAlign = VerticalAlignment::top,
                         const HorizontalAlignment hAlign = HorizontalAlignment::left,
                         const Vector3& textColor = Vector3(1, 1, 1),
                         const bool addBackgroundColor = false, const Vector3& backgroundColor = Vector3(0, 0, 0)) const;
+        const DrawStatistics& getDrawStatistics(void) const noexcept;
+        void resetDrawStatistics(void) noexcept;
+        /**@return The hits and misses of the cache of line breaks, since the TextRenderer was created.*/
+        const LineLayoutCache::Statistics& getLayoutCacheStatistics(void) const noexcept;
+        /**@return The occupancy of the glyph cache, and its evictions since the TextRenderer was created.*/
+        const GlyphCache::Statistics& getGlyphCacheStatistics(void) const noexcept;
 };
+
+#endif //TEXT_RENDERER_HPP
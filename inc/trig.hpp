@@ -0,0 +1,94 @@
+#ifndef TRIG_HPP
+#define TRIG_HPP
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/**Sine and cosine for the transformation and camera code.
+ *
+ * sinCos computes both at once. Building with FAST_TRIG defined (make FAST_TRIG=1) makes it use the approximation
+ * fastSinCos instead of std::sin and std::cos, trading precision for throughput. Batches of angles, for example the
+ * rotations of many objects, should use the batched sinCos: the approximation processes four angles per SSE2
+ * instruction.
+ *
+ * fastSinCos reduces the angle to [-pi/4, pi/4] and evaluates minimax polynomials, without branches or table lookups.
+ * For |x| <= 8192 the absolute error of both results is below 2^-23 (about 1.2e-7). Beyond that the range reduction
+ * loses precision, and for infinities and NaN both results are NaN. The scalar and the batched version perform the same
+ * operations in the same order, so their results are identical for every input.*/
+namespace Trig {
+    /**The sine and cosine of one angle.*/
+    struct SinCos {
+        float sin;
+        float cos;
+    };
+
+    /**@return The approximate sine and cosine of x, see the namespace documentation.*/
+    inline SinCos fastSinCos(const float x) noexcept;
+    /**Computes sin[i] and cos[i] of x[i] for i < count with fastSinCos. The arrays may not overlap.*/
+    void fastSinCos(const float* x, float* sin, float* cos, const std::size_t count) noexcept;
+
+    /**@return The sine and cosine of x: fastSinCos if built with FAST_TRIG, the standard library otherwise.*/
+    inline SinCos sinCos(const float x) noexcept;
+    /**Computes sin[i] and cos[i] of x[i] for i < count: fastSinCos if built with FAST_TRIG, the standard library
+     * otherwise. The arrays may not overlap.*/
+    void sinCos(const float* x, float* sin, float* cos, const std::size_t count) noexcept;
+
+    /**Constants of fastSinCos, shared with the batched implementation.*/
+    namespace Detail {
+        constexpr float twoOverPi = 0.636619772367581343f;
+        /**Adding and subtracting 1.5 * 2^23 rounds to the nearest integer, without a branch or a libm call.*/
+        constexpr float roundingConstant = 12582912.0f;
+        /**The quadrant number is clamped to +-2^30 before it is converted to an integer, where the conversion of huge
+         * angles, infinities and NaN would be undefined. Only its lowest two bits are used.*/
+        constexpr float quadrantLimit = 1073741824.0f;
+        /**pi/2 split in three parts (Cody-Waite), so the products with the quadrant number of the first two are exact.*/
+        constexpr float piOverTwo1 = 1.5703125f;
+        constexpr float piOverTwo2 = 4.837512969970703125e-4f;
+        constexpr float piOverTwo3 = 7.54978995489188216e-8f;
+        /**Minimax coefficients for sin(r) = r + r^3 * (s1 + r^2 * (s2 + r^2 * s3)) on [-pi/4, pi/4].*/
+        constexpr float sin1 = -1.6666654611e-1f;
+        constexpr float sin2 = 8.3321608736e-3f;
+        constexpr float sin3 = -1.9515295891e-4f;
+        /**Minimax coefficients for cos(r) = 1 - r^2 / 2 + r^4 * (c1 + r^2 * (c2 + r^2 * c3)) on [-pi/4, pi/4].*/
+        constexpr float cos1 = 4.166664568298827e-2f;
+        constexpr float cos2 = -1.388731625493765e-3f;
+        constexpr float cos3 = 2.443315711809948e-5f;
+    }
+}
+
+inline Trig::SinCos Trig::fastSinCos(const float x) noexcept
+{
+    using namespace Detail;
+    // x = quadrant * pi/2 + r, with r in [-pi/4, pi/4].
+    const float rounded = (x * twoOverPi + roundingConstant) - roundingConstant;
+    // In the order of _mm_min_ps and _mm_max_ps, so NaN becomes quadrantLimit like in the batched version.
+    const float clamped = rounded < quadrantLimit ? rounded : quadrantLimit;
+    const std::int32_t quadrant = static_cast<std::int32_t>(clamped > -quadrantLimit ? clamped : -quadrantLimit);
+    float r = x - rounded * piOverTwo1;
+    r -= rounded * piOverTwo2;
+    r -= rounded * piOverTwo3;
+    const float r2 = r * r;
+    const float s = r + r * r2 * (sin1 + r2 * (sin2 + r2 * sin3));
+    const float c = (1 - 0.5f * r2) + r2 * r2 * (cos1 + r2 * (cos2 + r2 * cos3));
+    // Depending on the quadrant, sin(x) is s, c, -s or -c and cos(x) is c, -s, -c or s.
+    const bool swap = quadrant & 1;
+    const std::uint32_t sinSign = static_cast<std::uint32_t>(quadrant & 2) << 30;
+    const std::uint32_t cosSign = static_cast<std::uint32_t>((quadrant + 1) & 2) << 30;
+    return SinCos{
+        std::bit_cast<float>(std::bit_cast<std::uint32_t>(swap ? c : s) ^ sinSign),
+        std::bit_cast<float>(std::bit_cast<std::uint32_t>(swap ? s : c) ^ cosSign),
+    };
+}
+
+inline Trig::SinCos Trig::sinCos(const float x) noexcept
+{
+#ifdef FAST_TRIG
+    return fastSinCos(x);
+#else
+    return SinCos{std::sin(x), std::cos(x)};
+#endif
+}
+
+#endif //TRIG_HPP
@@ -0,0 +1,154 @@
+#ifndef UNIFORM_HANDLE_HPP
+#define UNIFORM_HANDLE_HPP
+
+#include "glad/glad.h"
+#include "matrix.hpp"
+#include "vector.hpp"
+
+/**How a C++ type maps to GLSL uniforms: which GL types it can be assigned to, and the glUniform call that sets it.
+ * GLint also covers bool and the samplers, which are set with an int as well.*/
+template <typename T>
+struct UniformTraits;
+
+template <>
+struct UniformTraits<GLint> {
+    static constexpr bool accepts(const GLenum type) noexcept
+    {
+        return type == GL_INT || type == GL_BOOL || type == GL_SAMPLER_2D || type == GL_SAMPLER_2D_ARRAY;
+    }
+    static void upload(const GLint location, const GLsizei count, const GLint *values)
+    {
+        glUniform1iv(location, count, values);
+    }
+};
+
+template <>
+struct UniformTraits<GLfloat> {
+    static constexpr bool accepts(const GLenum type) noexcept
+    {
+        return type == GL_FLOAT;
+    }
+    static void upload(const GLint location, const GLsizei count, const GLfloat *values)
+    {
+        glUniform1fv(location, count, values);
+    }
+};
+
+template <>
+struct UniformTraits<Vector2> {
+    static constexpr bool accepts(const GLenum type) noexcept
+    {
+        return type == GL_FLOAT_VEC2;
+    }
+    static void upload(const GLint location, const GLsizei count, const Vector2 *values)
+    {
+        glUniform2fv(location, count, values->data());
+    }
+};
+
+template <>
+struct UniformTraits<Vector3> {
+    static constexpr bool accepts(const GLenum type) noexcept
+    {
+        return type == GL_FLOAT_VEC3;
+    }
+    static void upload(const GLint location, const GLsizei count, const Vector3 *values)
+    {
+        glUniform3fv(location, count, values->data());
+    }
+};
+
+template <>
+struct UniformTraits<Vector4> {
+    static constexpr bool accepts(const GLenum type) noexcept
+    {
+        return type == GL_FLOAT_VEC4;
+    }
+    static void upload(const GLint location, const GLsizei count, const Vector4 *values)
+    {
+        glUniform4fv(location, count, values->data());
+    }
+};
+
+/**Square float matrices of either layout. Row based matrices are uploaded with transpose set to true.*/
+template <std::size_t N, MatrixLayout Layout> requires (N == 3 || N == 4)
+struct UniformTraits<Matrix<float, N, N, Layout>> {
+    static constexpr bool accepts(const GLenum type) noexcept
+    {
+        return type == (N == 3 ? GL_FLOAT_MAT3 : GL_FLOAT_MAT4);
+    }
+    static void upload(const GLint location, const GLsizei count, const Matrix<float, N, N, Layout> *values)
+    {
+        uploadData(location, count, values->data());
+    }
+    /**Upload count matrices from data, stored one after the other in the layout of Layout.*/
+    static void uploadData(const GLint location, const GLsizei count, const float *data)
+    {
+        const GLboolean transpose = Layout == MatrixLayout::rowMajor ? GL_TRUE : GL_FALSE;
+        if constexpr (N == 3) {
+            glUniformMatrix3fv(location, count, transpose, data);
+        } else {
+            glUniformMatrix4fv(location, count, transpose, data);
+        }
+    }
+};
+
+/**A uniform of a ShaderProgram, obtained with ShaderProgram::getUniform, which checks that T matches the type in the
+ * shader. Setting it is a single glUniform call on the stored location: there is no lookup by name.
+ * Like glUniform, the setters apply to the shader program which is in use.*/
+template <typename T>
+class UniformHandle {
+    private:
+        GLint location;
+        GLsizei size;
+
+        friend class ShaderProgram;
+        UniformHandle(const GLint location, const GLsizei size) noexcept;
+    public:
+        /**A handle to no uniform. Setting it does nothing.*/
+        UniformHandle(void) noexcept;
+
+        void set(const T &value) const;
+        /**Set the first count elements of a uniform array. count may not exceed the size of the array.*/
+        void set(const T *values, const GLsizei count) const;
+        /**Set a matrix from its elements, in the layout of T. For example UniformHandle<ColumnMajorMatrix4> accepts
+         * OpenGlMatrix::columnMajorData().*/
+        void setData(const float *data) const requires requires (const float *d) { UniformTraits<T>::uploadData(0, 1, d); };
+        /**@return The number of elements: 1, unless the uniform is an array.*/
+        GLsizei getSize(void) const noexcept;
+};
+
+template <typename T>
+UniformHandle<T>::UniformHandle(const GLint location, const GLsizei size) noexcept : location(location), size(size)
+{}
+
+template <typename T>
+UniformHandle<T>::UniformHandle(void) noexcept : location(-1), size(0)
+{}
+
+template <typename T>
+inline void UniformHandle<T>::set(const T &value) const
+{
+    UniformTraits<T>::upload(this->location, 1, &value);
+}
+
+template <typename T>
+inline void UniformHandle<T>::set(const T *values, const GLsizei count) const
+{
+    UniformTraits<T>::upload(this->location, count, values);
+}
+
+template <typename T>
+inline void UniformHandle<T>::setData(const float *data) const
+    requires requires (const float *d) { UniformTraits<T>::uploadData(0, 1, d); }
+{
+    UniformTraits<T>::uploadData(this->location, 1, data);
+}
+
+template <typename T>
+GLsizei UniformHandle<T>::getSize(void) const noexcept
+{
+    return this->size;
+}
+
+#endif //UNIFORM_HANDLE_HPP
@@ -0,0 +1,46 @@
+#ifndef UNIFORM_TABLE_HPP
+#define UNIFORM_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "glad/glad.h"
+
+/**The active uniforms of a shader program, by name: a flat hash table with open addressing and linear probing.
+ * It is filled once, after linking, and only read afterwards. A lookup hashes the name and compares it with the
+ * entries in one contiguous array, without allocating memory or calling OpenGL.*/
+class UniformTable {
+    public:
+        /**What glGetActiveUniform reports about a uniform.*/
+        struct Uniform {
+            std::string name;
+            GLint location;
+            /**The GL type, like GL_FLOAT_VEC3 or GL_SAMPLER_2D.*/
+            GLenum type;
+            /**The number of elements, 1 unless it is an array.*/
+            GLint size;
+        };
+    private:
+        struct Slot {
+            std::uint64_t hash;
+            Uniform uniform;
+        };
+        /**A power of two in size, at most half full, so probe sequences stay short. Slots with an empty name are free.*/
+        std::vector<Slot> slots;
+
+        static std::uint64_t hash(const std::string_view name) noexcept;
+        void insert(const Uniform &uniform);
+    public:
+        UniformTable(void) = default;
+        /**Reflect the active uniforms of program with glGetActiveUniform. Uniforms in a uniform block have no location
+         * and are left out. An array is stored under its name both with and without the "[0]" OpenGL appends.*/
+        explicit UniformTable(const GLuint program);
+
+        /**@return The uniform called name, or nullptr if the program has no such active uniform.*/
+        const Uniform* find(const std::string_view name) const noexcept;
+};
+
+#endif //UNIFORM_TABLE_HPP
@@ -0,0 +1,54 @@
+#ifndef UTF8_HPP
+#define UTF8_HPP
+
+#include <cstddef>
+#include <string_view>
+
+/**Decoding of UTF-8, the encoding of every std::string the TextRenderer draws.*/
+namespace Utf8 {
+    /**What malformed input decodes to, drawn by most fonts as a question mark in a diamond.*/
+    constexpr char32_t replacementCharacter = 0xFFFD;
+
+    /**Decode the code point that starts at text[pos], and move pos to the byte after it.
+     * Malformed sequences (stray continuation bytes, truncated or overlong sequences, surrogates and values above
+     * U+10FFFF) decode to replacementCharacter and skip one byte, so decoding always makes progress.
+     * @warning pos must be less than text.length().*/
+    constexpr char32_t decode(const std::string_view text, std::size_t &pos) noexcept
+    {
+        const unsigned char lead = static_cast<unsigned char>(text[pos++]);
+        if (lead < 0x80)
+            return lead;
+        std::size_t length;
+        char32_t codePoint;
+        char32_t minimum;
+        if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            codePoint = lead & 0x1F;
+            minimum = 0x80;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            codePoint = lead & 0x0F;
+            minimum = 0x800;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            codePoint = lead & 0x07;
+            minimum = 0x10000;
+        } else {
+            return replacementCharacter;
+        }
+        if (text.length() - pos < length - 1)
+            return replacementCharacter;
+        for (std::size_t i = 0; i < length - 1; ++i) {
+            const unsigned char continuation = static_cast<unsigned char>(text[pos + i]);
+            if ((continuation & 0xC0) != 0x80)
+                return replacementCharacter;
+            codePoint = (codePoint << 6) | (continuation & 0x3F);
+        }
+        if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+            return replacementCharacter;
+        pos += length - 1;
+        return codePoint;
+    }
+}
+
+#endif //UTF8_HPP
@@ -0,0 +1,323 @@
+#ifndef VECTOR_HPP
+#define VECTOR_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "half.hpp"
+#include "matrix.hpp"
+#include "matrix4Kernels.hpp"
+#include "vectorExpression.hpp"
+
+/**Represents an N x 1 vector with elements of type T (float, double or Half), without any padding: a Vector3 takes 12
+ * bytes. Use the aliases at the bottom of this file, like Vector3 and Vector4.
+ * Everything is constexpr, see also Matrix.
+ * Addition, subtraction and multiplication with a scalar create expressions which are evaluated in one pass, see
+ * VectorExpression. Converting between element types and sizes is explicit.*/
+template <typename T, std::size_t N>
+class Vector : public VectorExpression<Vector<T, N>> {
+    private:
+        std::array<T, N> vec;
+        /**std::sqrt is not constexpr. This is Newton's method, for use in constant expressions only.*/
+        static constexpr ArithmeticType<T> constexprSqrt(const ArithmeticType<T> f);
+    public:
+        using value_type = T;
+        static constexpr std::size_t size = N;
+
+        /**Default constructor, initializes every element to 0.*/
+        constexpr Vector(void);
+        /**Construct a Vector2 from up to two values.*/
+        constexpr Vector(const T x, const T y = 0) requires (N == 2);
+        /**Construct a Vector3 from up to three values.*/
+        constexpr Vector(const T x, const T y = 0, const T z = 0) requires (N == 3);
+        /**Construct a Vector4 from up to four values.*/
+        constexpr Vector(const T x, const T y = 0, const T z = 0, const T w = 0) requires (N == 4);
+        /**Construct a Vector from an array.*/
+        constexpr Vector(const std::array<T, N> &vector);
+        /**Construct a Vector from a smaller one and a last element, like a point Vector4(position, 1).*/
+        constexpr Vector(const Vector<T, N - 1> &vector, const T last) requires (N > 1);
+        /**Evaluate an expression, see VectorExpression.*/
+        template <typename Expression>
+            requires (Expression::size == N && std::is_same_v<typename Expression::value_type, T>)
+        constexpr Vector(const VectorExpression<Expression> &expr);
+        /**Convert from another element type and/or size. Missing elements are 0, superfluous elements are dropped.*/
+        template <typename U, std::size_t M>
+            requires (M != N || !std::is_same_v<U, T>)
+        explicit constexpr Vector(const Vector<U, M> &other);
+        /**Return a pointer to a c-style array containing the current data in this vector.
+         * See also: std::array::data.*/
+        constexpr const T* data(void) const noexcept;
+
+        /**@return vec[0]*/
+        constexpr T x() const;
+        /**@return vec[1]*/
+        constexpr T y() const requires (N >= 2);
+        /**@return vec[2]*/
+        constexpr T z() const requires (N >= 3);
+        /**@return vec[3]*/
+        constexpr T w() const requires (N >= 4);
+        /**@return The value at position i.
+         * @warning Throws range_error if i >= N*/
+        constexpr T operator[](const std::size_t i) const;
+        /**@return The value at position i, for use by VectorExpression.
+         * @warning i is not checked.*/
+        constexpr T element(const std::size_t i) const;
+
+        /**Normalize the vector. A normalized vector has a length of 1 (sqrt(a^2 + b^2 + c^2 + ..) = 1).
+         * In a constant expression the square root is computed with Newton's method in double precision.*/
+        static constexpr Vector normalize(Vector vec);
+        /**Calculate the cross product lhs x rhs.*/
+        static constexpr Vector crossProduct(const Vector &lhs, const Vector &rhs) requires (N == 3);
+        /**Multiply every element of this Vector with f.*/
+        constexpr Vector& operator*=(const ArithmeticType<T> f);
+        /**Add another Vector, or an expression, to this one.*/
+        template <typename Expression>
+            requires (Expression::size == N && std::is_same_v<typename Expression::value_type, T>)
+        constexpr Vector& operator+=(const VectorExpression<Expression> &expr);
+        /**Subtract another Vector, or an expression, from this one.*/
+        template <typename Expression>
+            requires (Expression::size == N && std::is_same_v<typename Expression::value_type, T>)
+        constexpr Vector& operator-=(const VectorExpression<Expression> &expr);
+        /**@return Whether every element is equal to the one of other.*/
+        constexpr bool operator==(const Vector &other) const;
+};
+
+using Vector2 = Vector<float, 2>;
+using Vector3 = Vector<float, 3>;
+using Vector4 = Vector<float, 4>;
+/**Double precision variants, for example for positions in large worlds.*/
+using Vector3d = Vector<double, 3>;
+using Vector4d = Vector<double, 4>;
+/**Half precision variants, for compact vertex and instance data.*/
+using Vector3h = Vector<Half, 3>;
+using Vector4h = Vector<Half, 4>;
+
+static_assert(sizeof(Vector3) == 3 * sizeof(float) && sizeof(Vector3h) == 3 * sizeof(Half),
+              "Vectors must not contain padding");
+
+/**Create a new Vector by multiplying a matrix and a vector. 4x4 float matrices use Matrix4Kernels.*/
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Vector<T, R> operator*(const Matrix<T, R, C, Layout> &lhs, const Vector<T, C> &rhs);
+/**Evaluate the expression, then multiply the matrix and the resulting vector.*/
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout, typename Expression>
+    requires (Expression::size == C && std::is_same_v<typename Expression::value_type, T>)
+constexpr Vector<T, R> operator*(const Matrix<T, R, C, Layout> &lhs, const VectorExpression<Expression> &rhs);
+
+template <typename T, std::size_t N>
+constexpr ArithmeticType<T> Vector<T, N>::constexprSqrt(const ArithmeticType<T> f)
+{
+    // Zero, negative numbers, infinity and NaN.
+    if (!(f > 0) || f > std::numeric_limits<ArithmeticType<T>>::max())
+        return f;
+    // Starting above the root, every step decreases until the root is reached in double precision.
+    double cur = f < 1 ? 1.0 : static_cast<double>(f);
+    while (true) {
+        const double next = (cur + f / cur) / 2;
+        if (next >= cur)
+            return static_cast<ArithmeticType<T>>(cur);
+        cur = next;
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr Vector<T, N>::Vector(void) : vec{}
+{}
+
+template <typename T, std::size_t N>
+constexpr Vector<T, N>::Vector(const T x, const T y) requires (N == 2) : vec{x, y}
+{}
+
+template <typename T, std::size_t N>
+constexpr Vector<T, N>::Vector(const T x, const T y, const T z) requires (N == 3) : vec{x, y, z}
+{}
+
+template <typename T, std::size_t N>
+constexpr Vector<T, N>::Vector(const T x, const T y, const T z, const T w) requires (N == 4) : vec{x, y, z, w}
+{}
+
+template <typename T, std::size_t N>
+constexpr Vector<T, N>::Vector(const std::array<T, N> &vector) : vec(vector)
+{}
+
+template <typename T, std::size_t N>
+constexpr Vector<T, N>::Vector(const Vector<T, N - 1> &vector, const T last) requires (N > 1) : vec{}
+{
+    for (std::size_t i = 0; i < N - 1; ++i) {
+        this->vec[i] = vector.element(i);
+    }
+    this->vec[N - 1] = last;
+}
+
+template <typename T, std::size_t N>
+template <typename Expression>
+    requires (Expression::size == N && std::is_same_v<typename Expression::value_type, T>)
+constexpr Vector<T, N>::Vector(const VectorExpression<Expression> &expr) : vec{}
+{
+    // At -O2 GCC does not unroll these loops over a few elements by itself. Left as loops, they are neither vectorized
+    // nor kept in registers, which makes an expression several times slower than the same code written out by hand
+    // (see make bench).
+#pragma GCC unroll 4
+    for (std::size_t i = 0; i < N; ++i) {
+        this->vec[i] = expr.element(i);
+    }
+}
+
+template <typename T, std::size_t N>
+template <typename U, std::size_t M>
+    requires (M != N || !std::is_same_v<U, T>)
+constexpr Vector<T, N>::Vector(const Vector<U, M> &other) : vec{}
+{
+    for (std::size_t i = 0; i < N && i < M; ++i) {
+        this->vec[i] = static_cast<T>(other.element(i));
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr const T* Vector<T, N>::data(void) const noexcept
+{
+    return this->vec.data();
+}
+
+template <typename T, std::size_t N>
+constexpr T Vector<T, N>::x() const
+{
+    return vec[0];
+}
+
+template <typename T, std::size_t N>
+constexpr T Vector<T, N>::y() const requires (N >= 2)
+{
+    return vec[1];
+}
+
+template <typename T, std::size_t N>
+constexpr T Vector<T, N>::z() const requires (N >= 3)
+{
+    return vec[2];
+}
+
+template <typename T, std::size_t N>
+constexpr T Vector<T, N>::w() const requires (N >= 4)
+{
+    return vec[3];
+}
+
+template <typename T, std::size_t N>
+constexpr Vector<T, N> Vector<T, N>::normalize(Vector vec)
+{
+    ArithmeticType<T> unit = 0;
+#pragma GCC unroll 4
+    for (const T &f : vec.vec) {
+        unit += f*f;
+    }
+    unit = std::is_constant_evaluated() ? constexprSqrt(unit) : std::sqrt(unit);
+#pragma GCC unroll 4
+    for (std::size_t i = 0; i < N; ++i) {
+        vec.vec[i] = vec.vec[i] / unit;
+    }
+    return vec;
+}
+
+template <typename T, std::size_t N>
+constexpr Vector<T, N> Vector<T, N>::crossProduct(const Vector &lhs, const Vector &rhs) requires (N == 3)
+{
+    const ArithmeticType<T> x = (lhs.vec[1] * rhs.vec[2]) - (lhs.vec[2] * rhs.vec[1]);
+    const ArithmeticType<T> y = (lhs.vec[2] * rhs.vec[0]) - (lhs.vec[0] * rhs.vec[2]);
+    const ArithmeticType<T> z = (lhs.vec[0] * rhs.vec[1]) - (lhs.vec[1] * rhs.vec[0]);
+    return Vector(x, y, z);
+}
+
+template <typename T, std::size_t N>
+constexpr Vector<T, N>& Vector<T, N>::operator*=(const ArithmeticType<T> f)
+{
+#pragma GCC unroll 4
+    for (std::size_t i = 0; i < this->vec.size(); ++i) {
+        this->vec[i] *= f;
+    }
+    return *this;
+}
+
+// Every element of an expression only depends on the same element of its operands, so the expression may refer to
+// this vector itself.
+template <typename T, std::size_t N>
+template <typename Expression>
+    requires (Expression::size == N && std::is_same_v<typename Expression::value_type, T>)
+constexpr Vector<T, N>& Vector<T, N>::operator+=(const VectorExpression<Expression> &expr)
+{
+#pragma GCC unroll 4
+    for (std::size_t i = 0; i < this->vec.size(); ++i) {
+        this->vec[i] += expr.element(i);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N>
+template <typename Expression>
+    requires (Expression::size == N && std::is_same_v<typename Expression::value_type, T>)
+constexpr Vector<T, N>& Vector<T, N>::operator-=(const VectorExpression<Expression> &expr)
+{
+#pragma GCC unroll 4
+    for (std::size_t i = 0; i < this->vec.size(); ++i) {
+        this->vec[i] -= expr.element(i);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N>
+constexpr bool Vector<T, N>::operator==(const Vector &other) const
+{
+    return this->vec == other.vec;
+}
+
+template <typename T, std::size_t N>
+constexpr T Vector<T, N>::operator[](const std::size_t i) const
+{
+    if (i >= N)
+        throw std::range_error("Vector index out of range");
+    return this->vec[i];
+}
+
+template <typename T, std::size_t N>
+constexpr T Vector<T, N>::element(const std::size_t i) const
+{
+    return this->vec[i];
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout>
+constexpr Vector<T, R> operator*(const Matrix<T, R, C, Layout> &lhs, const Vector<T, C> &rhs)
+{
+    if constexpr (std::is_same_v<T, float> && R == 4 && C == 4) {
+        if (!std::is_constant_evaluated()) {
+            if constexpr (Layout == MatrixLayout::rowMajor) {
+                std::array<float, 4> res;
+                Matrix4Kernels::multiplyVector(lhs.data(), rhs.data(), res.data());
+                return Vector<T, R>(res);
+            } else {
+                return Matrix4(lhs) * rhs;
+            }
+        }
+    }
+    // The same operations, in the same order, as the scalar reference implementation in Matrix4Kernels.
+    std::array<T, R> res = {};
+    for (std::size_t i = 0; i < R; ++i) {
+        ArithmeticType<T> sum = lhs(i, 0) * rhs.element(0);
+        for (std::size_t k = 1; k < C; ++k) {
+            sum += lhs(i, k) * rhs.element(k);
+        }
+        res[i] = sum;
+    }
+    return Vector<T, R>(res);
+}
+
+template <typename T, std::size_t R, std::size_t C, MatrixLayout Layout, typename Expression>
+    requires (Expression::size == C && std::is_same_v<typename Expression::value_type, T>)
+constexpr Vector<T, R> operator*(const Matrix<T, R, C, Layout> &lhs, const VectorExpression<Expression> &rhs)
+{
+    return lhs * Vector<T, C>(rhs);
+}
+
+#endif //VECTOR_HPP
@@ -0,0 +1,139 @@
+#ifndef VECTOR_EXPRESSION_HPP
+#define VECTOR_EXPRESSION_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include "half.hpp"
+
+template <typename T, std::size_t N>
+class Vector;
+
+/**Base class of everything that can appear in an element-wise Vector expression: Vector itself, and the nodes below,
+ * which are returned by the arithmetic operators instead of a computed Vector.
+ * Nothing is computed until the expression is assigned to a Vector or added to / subtracted from one. At that point
+ * every element is computed once, in a single loop, without creating intermediate vectors. For example
+ * cameraPos += movement * direction * speed;
+ * compiles to one loop of three multiply-adds.
+ * Every expression has a value_type and a size, like Vector. Both operands of + and - must have the same ones. Elements
+ * are computed in ArithmeticType<value_type>, so Half vectors compute in float.
+ *
+ * The nodes refer to the vectors in the expression, they do not copy them.
+ * @warning Do not store an expression with auto, it may then refer to vectors that no longer exist. Store the result
+ * in a Vector instead.*/
+template <typename Derived>
+class VectorExpression {
+    public:
+        /**@return The expression as the type it really is.*/
+        constexpr const Derived& derived(void) const noexcept
+        {
+            return static_cast<const Derived&>(*this);
+        }
+        /**@return Element i of the result, computed on the spot.
+         * @warning i is not checked.*/
+        constexpr auto element(const std::size_t i) const
+        {
+            return derived().element(i);
+        }
+};
+
+/**Whether T is a Vector, as opposed to an expression node.*/
+template <typename T>
+struct IsVector : std::false_type {};
+template <typename T, std::size_t N>
+struct IsVector<Vector<T, N>> : std::true_type {};
+
+/**How an operand is stored inside an expression node: vectors by reference, nodes (which are small) by value.*/
+template <typename Expression>
+using VectorOperand = std::conditional_t<IsVector<Expression>::value, const Expression&, Expression>;
+
+/**Whether the expressions can be combined element-wise.*/
+template <typename Lhs, typename Rhs>
+concept MatchingVectorExpressions = Lhs::size == Rhs::size
+                                    && std::is_same_v<typename Lhs::value_type, typename Rhs::value_type>;
+
+/**Node for lhs + rhs.*/
+template <typename Lhs, typename Rhs>
+class VectorSum : public VectorExpression<VectorSum<Lhs, Rhs>> {
+    private:
+        VectorOperand<Lhs> lhs;
+        VectorOperand<Rhs> rhs;
+    public:
+        using value_type = typename Lhs::value_type;
+        static constexpr std::size_t size = Lhs::size;
+
+        constexpr VectorSum(const Lhs &left, const Rhs &right) : lhs(left), rhs(right)
+        {}
+        constexpr auto element(const std::size_t i) const
+        {
+            return lhs.element(i) + rhs.element(i);
+        }
+};
+
+/**Node for lhs - rhs.*/
+template <typename Lhs, typename Rhs>
+class VectorDifference : public VectorExpression<VectorDifference<Lhs, Rhs>> {
+    private:
+        VectorOperand<Lhs> lhs;
+        VectorOperand<Rhs> rhs;
+    public:
+        using value_type = typename Lhs::value_type;
+        static constexpr std::size_t size = Lhs::size;
+
+        constexpr VectorDifference(const Lhs &left, const Rhs &right) : lhs(left), rhs(right)
+        {}
+        constexpr auto element(const std::size_t i) const
+        {
+            return lhs.element(i) - rhs.element(i);
+        }
+};
+
+/**Node for expression * factor.*/
+template <typename Expression>
+class VectorScaled : public VectorExpression<VectorScaled<Expression>> {
+    private:
+        VectorOperand<Expression> expression;
+        ArithmeticType<typename Expression::value_type> factor;
+    public:
+        using value_type = typename Expression::value_type;
+        static constexpr std::size_t size = Expression::size;
+
+        constexpr VectorScaled(const Expression &expr, const ArithmeticType<value_type> f) : expression(expr), factor(f)
+        {}
+        constexpr auto element(const std::size_t i) const
+        {
+            return expression.element(i) * factor;
+        }
+};
+
+/**Create an expression for the element-wise sum of lhs and rhs.*/
+template <typename Lhs, typename Rhs> requires MatchingVectorExpressions<Lhs, Rhs>
+constexpr VectorSum<Lhs, Rhs> operator+(const VectorExpression<Lhs> &lhs, const VectorExpression<Rhs> &rhs)
+{
+    return VectorSum<Lhs, Rhs>(lhs.derived(), rhs.derived());
+}
+
+/**Create an expression for the element-wise difference of lhs and rhs.*/
+template <typename Lhs, typename Rhs> requires MatchingVectorExpressions<Lhs, Rhs>
+constexpr VectorDifference<Lhs, Rhs> operator-(const VectorExpression<Lhs> &lhs, const VectorExpression<Rhs> &rhs)
+{
+    return VectorDifference<Lhs, Rhs>(lhs.derived(), rhs.derived());
+}
+
+/**Create an expression for every element of lhs multiplied with rhs.*/
+template <typename Expression>
+constexpr VectorScaled<Expression> operator*(const VectorExpression<Expression> &lhs,
+                                             const ArithmeticType<typename Expression::value_type> rhs)
+{
+    return VectorScaled<Expression>(lhs.derived(), rhs);
+}
+
+/**Create an expression for every element of rhs multiplied with lhs.*/
+template <typename Expression>
+constexpr VectorScaled<Expression> operator*(const ArithmeticType<typename Expression::value_type> lhs,
+                                             const VectorExpression<Expression> &rhs)
+{
+    return VectorScaled<Expression>(rhs.derived(), lhs);
+}
+
+#endif //VECTOR_EXPRESSION_HPP
@@ -1,8 +1,8 @@
 #ifndef VIEW_MATRIX_HPP
 #define VIEW_MATRIX_HPP
 
-#include "matrix4.hpp"
-#include "vector3.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
 #include "glfwWindow.hpp"
 
 class ViewMatrix {
@@ -12,6 +12,7 @@ class ViewMatrix {
         bool leftActive;
         bool rightActive;
         Matrix4 lookAtMatrix;
+        ColumnMajorMatrix4 columnMajorLookAtMatrix;
         const float sensitivity;
         const float moveSpeed;
         GlfwWindow* glfwWindow;
@@ -31,7 +32,6 @@ class ViewMatrix {
         void processWindowFocus(const bool focused);
         void unregisterGlfwWindow(void);
         Vector3 getCameraFront(const float pitch, const float yaw) const;
-        Matrix4 getLookAtMatrix(const Vector3 &worldUp, const Vector3 &cameraDirection, const Vector3 &cameraPos) const;
     public:
         explicit ViewMatrix(const float sensitivity = 0.001, const float moveSpeed = 2.5);
         ~ViewMatrix(void);
@@ -42,6 +42,12 @@ class ViewMatrix {
         void update(void);
         void registerWithGlfwWindow(GlfwWindow& w);
         const float* data(void) const noexcept;
+        /**@return The view matrix, column based, ready for OpenGL.*/
+        const float* columnMajorData(void) const noexcept;
+        /**@return The view matrix.*/
+        const Matrix4& getMatrix(void) const noexcept;
+        /**@return The position of the camera in world coordinates.*/
+        const Vector3& getCameraPosition(void) const noexcept;
 };
 
 #endif //VIEW_MATRIX_HPP
@@ -0,0 +1,8 @@
+// See CameraUniformBuffer.
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    mat4 overlayProjection;
+    vec4 cameraPosition;
+};
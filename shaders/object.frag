@@ -0,0 +1,25 @@
+#version 330 core
+// Variants:
+// TEXTURED: the color is read from ourTexture.
+// LIGHT_SOURCE: the object is white.
+// Otherwise the object has the color objectColor, lit by lightColor.
+out vec4 FragColor;
+
+#if defined(TEXTURED)
+in vec2 TexCoord;
+uniform sampler2D ourTexture;
+#elif !defined(LIGHT_SOURCE)
+uniform vec3 objectColor;
+uniform vec3 lightColor;
+#endif
+
+void main()
+{
+#if defined(TEXTURED)
+    FragColor = texture(ourTexture, TexCoord);
+#elif defined(LIGHT_SOURCE)
+    FragColor = vec4(1.0);
+#else
+    FragColor = vec4(lightColor * objectColor, 1.0);
+#endif
+}
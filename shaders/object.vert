@@ -0,0 +1,33 @@
+#version 330 core
+// Variants:
+// INSTANCED: the model matrix is a per-instance attribute instead of a uniform. See InstancedRenderer.
+// TEXTURED: passes the texture coordinates on to the fragment shader.
+layout (location = 0) in vec3 aPos;
+#ifdef TEXTURED
+layout (location = 1) in vec2 aTexCoord;
+out vec2 TexCoord;
+#endif
+#ifdef INSTANCED
+// The upper three rows of the model matrix, per instance.
+layout (location = 2) in vec4 aModelRow0;
+layout (location = 3) in vec4 aModelRow1;
+layout (location = 4) in vec4 aModelRow2;
+#else
+uniform mat4 model;
+#endif
+
+#include "camera.glsl"
+
+void main()
+{
+    vec4 pos = vec4(aPos, 1.0f);
+#ifdef INSTANCED
+    vec4 worldPos = vec4(dot(aModelRow0, pos), dot(aModelRow1, pos), dot(aModelRow2, pos), 1.0f);
+#else
+    vec4 worldPos = model * pos;
+#endif
+    gl_Position = viewProjection * worldPos;
+#ifdef TEXTURED
+    TexCoord = aTexCoord;
+#endif
+}
@@ -1,11 +1,32 @@
 #version 330 core
-layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+// One instance per glyph, see TextRenderer::GlyphInstance. The quad is made from gl_VertexID, drawn as a triangle strip
+// of four vertices.
+layout (location = 0) in vec2 position; // The bottom left corner, in pixels.
+// <x, y, width, height> in texels. The page of the glyph cache is in the bits of y above TextRenderer::pageShift.
+layout (location = 1) in uvec4 atlasRectangle;
+layout (location = 2) in vec4 color;
 out vec2 TexCoords;
+flat out int glyphPage;
+out vec4 glyphColor;
 
-uniform mat4 projection;
+uniform sampler2DArray text;
+uniform float scale;
+// Where the text is placed, the positions are relative to it.
+uniform vec2 offset;
+
+#include "camera.glsl"
+
+const uint pageShift = 12u;
 
 void main()
 {
-    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
-    TexCoords = vertex.zw;
+    // (0, 0), (1, 0), (0, 1), (1, 1)
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 atlasPosition = vec2(atlasRectangle.x, atlasRectangle.y & ((1u << pageShift) - 1u));
+    vec2 size = vec2(atlasRectangle.zw);
+    gl_Position = overlayProjection * vec4(offset + position + corner * size * scale, 0.0, 1.0);
+    // The rows of the page go down, the y coordinate goes up.
+    TexCoords = (atlasPosition + vec2(corner.x, 1.0 - corner.y) * size) / vec2(textureSize(text, 0).xy);
+    glyphPage = int(atlasRectangle.y >> pageShift);
+    glyphColor = color;
 }
@@ -1,9 +1,11 @@
 #version 330 core
 layout (location = 0) in vec2 vertex; // <vec2 pos>
+// Where the text is placed, the positions are relative to it.
+uniform vec2 offset;
 
-uniform mat4 projection;
+#include "camera.glsl"
 
 void main()
 {
-    gl_Position = projection * vec4(vertex.xy, -1.0, 1.0);
+    gl_Position = overlayProjection * vec4(offset + vertex.xy, -1.0, 1.0);
 }
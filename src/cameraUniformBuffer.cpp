@@ -0,0 +1,38 @@
+#include <cstring>
+
+#include "cameraUniformBuffer.hpp"
+#include "projectionMatrix.hpp"
+#include "viewMatrix.hpp"
+
+CameraUniformBuffer::CameraUniformBuffer(void)
+{
+    glGenBuffers(1, &this->buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, this->buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), &this->block, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, this->buffer);
+}
+
+CameraUniformBuffer::~CameraUniformBuffer(void)
+{
+    glDeleteBuffers(1, &this->buffer);
+}
+
+void CameraUniformBuffer::update(const ViewMatrix &view, const ProjectionMatrix &projection,
+                                 const ProjectionMatrix &overlay)
+{
+    const Block next{
+        ColumnMajorMatrix4(view.getMatrix()),
+        ColumnMajorMatrix4(projection.getMatrix()),
+        ColumnMajorMatrix4(projection.getMatrix() * view.getMatrix()),
+        ColumnMajorMatrix4(overlay.getMatrix()),
+        Vector4(view.getCameraPosition(), 1),
+    };
+    // While the camera stands still, there is nothing to upload.
+    if (std::memcmp(&next, &this->block, sizeof(Block)) == 0)
+        return;
+    this->block = next;
+    glBindBuffer(GL_UNIFORM_BUFFER, this->buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &this->block);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
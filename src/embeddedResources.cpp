@@ -0,0 +1,11 @@
+#include "embeddedResources.hpp"
+
+const EmbeddedResources::Resource* EmbeddedResources::find(const std::string_view path) noexcept
+{
+    // There are only a few resources, a linear search is fast enough.
+    for (const Resource &resource : Detail::resources) {
+        if (resource.path == path)
+            return &resource;
+    }
+    return nullptr;
+}
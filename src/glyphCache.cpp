@@ -0,0 +1,273 @@
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+#include "glyphCache.hpp"
+
+namespace {
+    /**Empty texels around every glyph, so texture filtering does not mix neighbours.*/
+    constexpr unsigned int glyphPadding = 1;
+}
+
+GlyphCache::GlyphCache(const Font &font, const unsigned int pageSize, const unsigned int pageCount) :
+    font(font), pageSize(pageSize), texture(0), use(0), generation(0), statistics{}
+{
+    GLint maxTextureSize, maxLayers;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (pageSize == 0 || pageSize > std::min(maxPageSize, static_cast<unsigned int>(maxTextureSize))
+        || pageCount == 0 || pageCount > std::min(maxPageCount, static_cast<unsigned int>(maxLayers))) {
+        FT_Done_Face(font.face);
+        FT_Done_FreeType(font.library);
+        std::ostringstream errStream;
+        errStream << "Glyph cache pages of " << pageSize << "x" << pageSize << " texels, " << pageCount
+                  << " of them, exceed the limits of " << std::min(maxPageSize, static_cast<unsigned int>(maxTextureSize))
+                  << " texels and " << std::min(maxPageCount, static_cast<unsigned int>(maxLayers)) << " pages";
+        throw std::runtime_error(errStream.str());
+    }
+    this->pages.reserve(pageCount);
+    for (unsigned int i = 0; i < pageCount; ++i) {
+        this->pages.push_back(Page{ShelfPacker(pageSize, pageSize, glyphPadding), {}, {}, 0, 0, 0, 0, 0, 0});
+    }
+    this->statistics.pageCount = pageCount;
+    this->statistics.totalTexels = static_cast<std::size_t>(pageSize) * pageSize * pageCount;
+
+    // The pages start out empty, the padding around the first glyphs must be.
+    const std::vector<unsigned char> empty(this->statistics.totalTexels, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glGenTextures(1, &this->texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8, pageSize, pageSize, pageCount, 0, GL_RED, GL_UNSIGNED_BYTE,
+                 empty.data());
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+GlyphCache::~GlyphCache(void)
+{
+    glDeleteTextures(1, &this->texture);
+    FT_Done_Face(this->font.face);
+    FT_Done_FreeType(this->font.library);
+}
+
+FT_Face GlyphCache::getFace(void) const noexcept
+{
+    return this->font.face;
+}
+
+GlyphCache::Glyph& GlyphCache::lookUp(const char32_t codePoint)
+{
+    const auto found = this->glyphs.find(codePoint);
+    if (found != this->glyphs.end())
+        return found->second;
+    Glyph glyph{};
+    // Index 0 is the missing glyph, usually an empty box, drawn for every code point the font has no glyph for.
+    glyph.index = FT_Get_Char_Index(this->font.face, codePoint);
+    glyph.page = -1;
+    if (FT_Load_Glyph(this->font.face, glyph.index, FT_LOAD_DEFAULT) == 0)
+        glyph.advance = static_cast<float>(this->font.face->glyph->advance.x);
+    else
+        glyph.rasterized = true;
+    this->statistics.knownGlyphs++;
+    return this->glyphs.emplace(codePoint, glyph).first->second;
+}
+
+const GlyphCache::Glyph& GlyphCache::getGlyph(const char32_t codePoint)
+{
+    return lookUp(codePoint);
+}
+
+void GlyphCache::beginUse(void) noexcept
+{
+    this->use++;
+}
+
+const GlyphCache::Glyph* GlyphCache::acquire(const char32_t codePoint)
+{
+    Glyph &glyph = lookUp(codePoint);
+    if (glyph.page < 0) {
+        // Empty glyphs, like the space, have nothing to draw.
+        if (glyph.rasterized && (glyph.width == 0 || glyph.rows == 0))
+            return nullptr;
+        if (!place(codePoint, glyph))
+            return nullptr;
+    }
+    this->pages[glyph.page].lastUse = this->use;
+    return &glyph;
+}
+
+bool GlyphCache::place(const char32_t codePoint, Glyph &glyph)
+{
+    // A glyph known to be too big is not rasterized again.
+    if (glyph.rasterized && std::max(glyph.width, glyph.rows) + 2 * glyphPadding > this->pageSize) {
+        this->statistics.rejections++;
+        return false;
+    }
+    const FT_Face face = this->font.face;
+    glyph.rasterized = true;
+    if (FT_Load_Glyph(face, glyph.index, FT_LOAD_RENDER) != 0) {
+        glyph.width = 0;
+        glyph.rows = 0;
+        return false;
+    }
+    this->statistics.rasterizations++;
+    const FT_Bitmap &bitmap = face->glyph->bitmap;
+    glyph.width = bitmap.width;
+    glyph.rows = bitmap.rows;
+    glyph.left = face->glyph->bitmap_left;
+    glyph.top = face->glyph->bitmap_top;
+    if (glyph.width == 0 || glyph.rows == 0)
+        return false;
+
+    ShelfPacker::Rectangle rectangle;
+    const int pageIndex = reserve(glyph.width, glyph.rows, rectangle);
+    if (pageIndex < 0) {
+        this->statistics.rejections++;
+        return false;
+    }
+    Page &page = this->pages[pageIndex];
+    for (unsigned int row = 0; row < glyph.rows; ++row) {
+        std::copy_n(bitmap.buffer + static_cast<std::ptrdiff_t>(row) * bitmap.pitch, glyph.width,
+                    page.texels.begin() + static_cast<std::ptrdiff_t>(rectangle.y + row) * this->pageSize + rectangle.x);
+    }
+    markDirty(page, rectangle.x, rectangle.y, rectangle.x + glyph.width, rectangle.y + glyph.rows);
+    if (page.glyphs.empty())
+        this->statistics.pagesInUse++;
+    page.glyphs.push_back(codePoint);
+    const std::size_t texels = static_cast<std::size_t>(glyph.width + glyphPadding) * (glyph.rows + glyphPadding);
+    page.usedTexels += texels;
+    this->statistics.usedTexels += texels;
+    this->statistics.residentGlyphs++;
+    glyph.page = pageIndex;
+    glyph.x = static_cast<std::uint16_t>(rectangle.x);
+    glyph.y = static_cast<std::uint16_t>(rectangle.y);
+    return true;
+}
+
+int GlyphCache::reserve(const unsigned int width, const unsigned int height, ShelfPacker::Rectangle &rectangle)
+{
+    if (std::max(width, height) + 2 * glyphPadding > this->pageSize)
+        return -1;
+    // Fill the pages already used first, then start a new one, and evict only when all are full.
+    int unusedPage = -1;
+    for (std::size_t i = 0; i < this->pages.size(); ++i) {
+        Page &page = this->pages[i];
+        if (page.texels.empty()) {
+            if (unusedPage < 0)
+                unusedPage = static_cast<int>(i);
+            continue;
+        }
+        if (const std::optional<ShelfPacker::Rectangle> position = page.packer.insert(width, height)) {
+            rectangle = *position;
+            return static_cast<int>(i);
+        }
+    }
+    int pageIndex = unusedPage;
+    if (pageIndex >= 0) {
+        this->pages[pageIndex].texels.assign(static_cast<std::size_t>(this->pageSize) * this->pageSize, 0);
+    } else {
+        // The page used least recently goes, unless the current use drew from it: its glyphs are not drawn yet.
+        for (std::size_t i = 0; i < this->pages.size(); ++i) {
+            const Page &page = this->pages[i];
+            if (page.lastUse != this->use && (pageIndex < 0 || page.lastUse < this->pages[pageIndex].lastUse))
+                pageIndex = static_cast<int>(i);
+        }
+        if (pageIndex < 0)
+            return -1;
+        evict(this->pages[pageIndex]);
+    }
+    const std::optional<ShelfPacker::Rectangle> position = this->pages[pageIndex].packer.insert(width, height);
+    if (!position)
+        return -1;
+    rectangle = *position;
+    return pageIndex;
+}
+
+void GlyphCache::evict(Page &page)
+{
+    for (const char32_t codePoint : page.glyphs) {
+        this->glyphs.at(codePoint).page = -1;
+    }
+    if (!page.glyphs.empty())
+        this->statistics.pagesInUse--;
+    this->statistics.pageEvictions++;
+    this->statistics.glyphEvictions += page.glyphs.size();
+    this->statistics.residentGlyphs -= page.glyphs.size();
+    this->statistics.usedTexels -= page.usedTexels;
+    page.glyphs.clear();
+    page.usedTexels = 0;
+    page.packer.clear();
+    // New glyphs must not be filtered together with the remains of the old ones, the page is uploaded whole.
+    std::fill(page.texels.begin(), page.texels.end(), 0);
+    markDirty(page, 0, 0, this->pageSize, this->pageSize);
+    this->generation++;
+}
+
+void GlyphCache::markDirty(Page &page, const unsigned int left, const unsigned int top, const unsigned int right,
+                           const unsigned int bottom) noexcept
+{
+    if (page.dirtyLeft >= page.dirtyRight) {
+        page.dirtyLeft = left;
+        page.dirtyTop = top;
+        page.dirtyRight = right;
+        page.dirtyBottom = bottom;
+    } else {
+        page.dirtyLeft = std::min(page.dirtyLeft, left);
+        page.dirtyTop = std::min(page.dirtyTop, top);
+        page.dirtyRight = std::max(page.dirtyRight, right);
+        page.dirtyBottom = std::max(page.dirtyBottom, bottom);
+    }
+}
+
+void GlyphCache::touchPages(const std::uint32_t pageMask) noexcept
+{
+    for (std::size_t i = 0; i < this->pages.size(); ++i) {
+        if (pageMask & (std::uint32_t(1) << i))
+            this->pages[i].lastUse = this->use;
+    }
+}
+
+void GlyphCache::flush(void)
+{
+    bool bound = false;
+    for (std::size_t i = 0; i < this->pages.size(); ++i) {
+        Page &page = this->pages[i];
+        if (page.dirtyLeft >= page.dirtyRight)
+            continue;
+        if (!bound) {
+            glBindTexture(GL_TEXTURE_2D_ARRAY, this->texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            // The rows of the changed area are rows of the whole page.
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(this->pageSize));
+            bound = true;
+        }
+        const unsigned int width = page.dirtyRight - page.dirtyLeft;
+        const unsigned int height = page.dirtyBottom - page.dirtyTop;
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, page.dirtyLeft, page.dirtyTop, static_cast<GLint>(i), width, height, 1,
+                        GL_RED, GL_UNSIGNED_BYTE,
+                        page.texels.data() + static_cast<std::size_t>(page.dirtyTop) * this->pageSize + page.dirtyLeft);
+        this->statistics.uploads++;
+        this->statistics.uploadedBytes += static_cast<std::size_t>(width) * height;
+        page.dirtyLeft = page.dirtyTop = page.dirtyRight = page.dirtyBottom = 0;
+    }
+    if (bound)
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+GLuint GlyphCache::getTexture(void) const noexcept
+{
+    return this->texture;
+}
+
+std::uint64_t GlyphCache::getGeneration(void) const noexcept
+{
+    return this->generation;
+}
+
+const GlyphCache::Statistics& GlyphCache::getStatistics(void) const noexcept
+{
+    return this->statistics;
+}
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <stdexcept>
+
+#include "instancedRenderer.hpp"
+#include "glErrorToString.hpp"
+
+static_assert(sizeof(Matrix3x4) == 12 * sizeof(float), "The instance buffer is uploaded from an array of Matrix3x4");
+
+InstancedRenderer::InstancedRenderer(const GLuint vertexArray, const GLsizei vertexCount,
+                                     const GLuint modelAttributeLocation) :
+    vertexArray(vertexArray), vertexCount(vertexCount), capacity(0), instanceCount(0)
+{
+    glGenBuffers(1, &this->instanceBuffer);
+    glBindVertexArray(this->vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, this->instanceBuffer);
+    for (GLuint row = 0; row < 3; ++row) {
+        glEnableVertexAttribArray(modelAttributeLocation + row);
+        glVertexAttribPointer(modelAttributeLocation + row, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix3x4),
+                              reinterpret_cast<void*>(row * 4 * sizeof(float)));
+        glVertexAttribDivisor(modelAttributeLocation + row, 1);
+    }
+    glBindVertexArray(0);
+    const GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        glDeleteBuffers(1, &this->instanceBuffer);
+        std::ostringstream errStream;
+        errStream << "Setting up the instance attributes at location " << modelAttributeLocation << " failed: "
+                  << glErrorToString(err);
+        throw std::runtime_error(errStream.str());
+    }
+}
+
+InstancedRenderer::~InstancedRenderer(void)
+{
+    glDeleteBuffers(1, &this->instanceBuffer);
+}
+
+void InstancedRenderer::reserve(const std::size_t count)
+{
+    if (count <= this->capacity)
+        return;
+    // Grow geometrically, so a slowly growing number of instances does not reallocate every frame.
+    this->capacity = std::max(count, 2 * this->capacity);
+    glBindBuffer(GL_ARRAY_BUFFER, this->instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, this->capacity * sizeof(Matrix3x4), nullptr, GL_DYNAMIC_DRAW);
+    // The new buffer is empty, so nothing may be skipped.
+    this->sourceVersions.clear();
+}
+
+void InstancedRenderer::upload(const std::size_t first, const std::size_t count) const
+{
+    glBindBuffer(GL_ARRAY_BUFFER, this->instanceBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Matrix3x4), count * sizeof(Matrix3x4),
+                    this->instances.data() + first);
+}
+
+void InstancedRenderer::setInstances(std::span<OpenGlMatrix> models)
+{
+    reserve(models.size());
+    this->instances.resize(models.size());
+    this->sourceVersions.resize(models.size(), 0);
+    this->instanceCount = models.size();
+
+    // Upload the range from the first to the last changed instance in one call.
+    std::size_t first = models.size();
+    std::size_t last = 0;
+    for (std::size_t i = 0; i < models.size(); ++i) {
+        OpenGlMatrix &model = models[i];
+        if (this->sourceVersions[i] == model.getVersion())
+            continue;
+        // The upper three rows of a row based 4x4 matrix are its first 12 elements.
+        std::array<float, 12> rows;
+        std::copy_n(model.data(), rows.size(), rows.begin());
+        this->instances[i] = Matrix3x4(rows);
+        this->sourceVersions[i] = model.getVersion();
+        first = std::min(first, i);
+        last = i;
+    }
+    if (first < models.size())
+        upload(first, last - first + 1);
+}
+
+void InstancedRenderer::setInstances(std::span<const Matrix4> models)
+{
+    reserve(models.size());
+    this->instances.resize(models.size());
+    for (std::size_t i = 0; i < models.size(); ++i) {
+        this->instances[i] = Matrix3x4(models[i]);
+    }
+    this->sourceVersions.clear();
+    this->instanceCount = models.size();
+    if (!models.empty())
+        upload(0, models.size());
+}
+
+void InstancedRenderer::draw(void) const
+{
+    if (this->instanceCount == 0)
+        return;
+    glBindVertexArray(this->vertexArray);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, this->vertexCount, static_cast<GLsizei>(this->instanceCount));
+}
+
+std::size_t InstancedRenderer::getInstanceCount(void) const noexcept
+{
+    return this->instanceCount;
+}
@@ -0,0 +1,76 @@
+#include <functional>
+
+#include "lineLayoutCache.hpp"
+#include "fnv1a.hpp"
+
+std::size_t LineLayoutCache::KeyHash::operator()(const Key &key) const noexcept
+{
+    // std::hash treats 0.0f and -0.0f the same, as operator== does. The text hash is already well mixed.
+    std::uint64_t hash = key.textHash;
+    hash = (hash ^ std::hash<float>{}(key.scale)) * Fnv1a::prime;
+    hash = (hash ^ std::hash<float>{}(key.maxLineLength)) * Fnv1a::prime;
+    return static_cast<std::size_t>(hash);
+}
+
+LineLayoutCache::Key LineLayoutCache::getKey(const std::string_view text, const float scale,
+                                             const float maxLineLength) noexcept
+{
+    return Key{Fnv1a::hash(text), scale, maxLineLength};
+}
+
+LineLayoutCache::LineLayoutCache(const std::size_t maxBytes) : maxBytes(maxBytes), statistics{}
+{}
+
+const std::vector<LineLayoutCache::Line>* LineLayoutCache::find(const std::string_view text, const float scale,
+                                                                const float maxLineLength)
+{
+    const auto it = this->index.find(getKey(text, scale, maxLineLength));
+    if (it == this->index.end() || it->second->text != text) {
+        this->statistics.misses++;
+        return nullptr;
+    }
+    this->statistics.hits++;
+    // Move the entry to the front, it is now the most recently used one.
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return &it->second->lines;
+}
+
+const std::vector<LineLayoutCache::Line>& LineLayoutCache::insert(const std::string_view text, const float scale,
+                                                                  const float maxLineLength, std::vector<Line> lines)
+{
+    const Key key = getKey(text, scale, maxLineLength);
+    // Replace an entry with the same key, which is either the same text or a hash collision.
+    const auto existing = this->index.find(key);
+    if (existing != this->index.end()) {
+        this->statistics.bytes -= existing->second->bytes;
+        this->entries.erase(existing->second);
+        this->index.erase(existing);
+    }
+    // The list and map nodes are estimated as the size of the entry.
+    const std::size_t bytes = sizeof(Entry) + text.size() + lines.size() * sizeof(Line);
+    this->entries.push_front(Entry{key, std::string(text), std::move(lines), bytes});
+    this->index.emplace(key, this->entries.begin());
+    this->statistics.bytes += bytes;
+    while (this->statistics.bytes > this->maxBytes && this->entries.size() > 1) {
+        const Entry &last = this->entries.back();
+        this->statistics.bytes -= last.bytes;
+        this->index.erase(last.key);
+        this->entries.pop_back();
+        this->statistics.evictions++;
+    }
+    this->statistics.entries = this->entries.size();
+    return this->entries.front().lines;
+}
+
+void LineLayoutCache::clear(void) noexcept
+{
+    this->entries.clear();
+    this->index.clear();
+    this->statistics.entries = 0;
+    this->statistics.bytes = 0;
+}
+
+const LineLayoutCache::Statistics& LineLayoutCache::getStatistics(void) const noexcept
+{
+    return this->statistics;
+}
@@ -0,0 +1,20 @@
+#include "lookAtMatrix.hpp"
+
+Matrix4 createLookAtMatrix(const Vector3 &worldUp, const Vector3 &cameraDirection, const Vector3 &cameraPos)
+{
+    Vector3 cameraRight = Vector3::normalize(Vector3::crossProduct(worldUp, cameraDirection));
+    Vector3 cameraUp = Vector3::normalize(Vector3::crossProduct(cameraDirection, cameraRight));
+    Matrix4 axisMat({
+        cameraRight.x(),        cameraRight.y(),        cameraRight.z(),        0,
+        cameraUp.x(),           cameraUp.y(),           cameraUp.z(),           0,
+        cameraDirection.x(),    cameraDirection.y(),    cameraDirection.z(),    0,
+        0,                      0,                      0,                      1,
+    });
+    Matrix4 posMat({
+        1,  0,  0,  -cameraPos.x(),
+        0,  1,  0,  -cameraPos.y(),
+        0,  0,  1,  -cameraPos.z(),
+        0,  0,  0,  1,
+    });
+    return axisMat * posMat;
+}
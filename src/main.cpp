@@ -6,8 +6,12 @@
 #include "perspectiveProjectionMatrix.hpp"
 #include "orthographicProjectionMatrix.hpp"
 #include "openglMatrix.hpp"
+#include "instancedRenderer.hpp"
+#include "cameraUniformBuffer.hpp"
 #include "shaderProgram.hpp"
+#include "shaderRegistry.hpp"
 #include "textRenderer.hpp"
+#include "textBlock.hpp"
 #include "GLFW/glfw3.h"
 #include "texture2D.hpp"
 
@@ -123,70 +127,97 @@ int main() {
     // Enable blending. This is required to properly display the text.
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    ShaderProgram lightCubeShader = []() -> ShaderProgram {
+    // Linked shader programs are stored here, so the next start does not have to compile them again.
+    const ProgramBinaryCache shaderCache("shaderCache");
+    ShaderRegistry shaderRegistry(&shaderCache);
+    // All programs are requested before anything else is set up, so the driver can compile them in the meantime.
+    const auto requestProgram = [&shaderRegistry](const ShaderProgram::Defines &defines) {
         try {
-            return ShaderProgram("shaders/vertex.vert", "shaders/fragmentLightsource.frag");
+            return shaderRegistry.requestProgram("shaders/object.vert", "shaders/object.frag", defines);
         } catch (const std::runtime_error &e) {
-            std::cerr << "An error occured during construction of OpenGL shader lightSourceShader: " << e.what();
+            std::cerr << "An error occured while reading the object shaders: " << e.what();
             std::exit(EXIT_FAILURE);
         }
-    }();
-    ShaderProgram lightingShader = []() -> ShaderProgram {
-        try {
-            return ShaderProgram("shaders/vertex.vert", "shaders/fragment.frag");
-        } catch (const std::runtime_error &e) {
-            std::cerr << "An error occured during construction of OpenGL shader lightingShader: " << e.what();
-            std::exit(EXIT_FAILURE);
-        }
-    }();
-    ShaderProgram textureShader = []() -> ShaderProgram {
-        try {
-            return ShaderProgram("shaders/texture.vert", "shaders/texture.frag");
-        } catch (const std::runtime_error &e) {
-            std::cerr << "An error occured during construction of OpenGL shader lightingShader: " << e.what();
-            std::exit(EXIT_FAILURE);
-        }
-    }();
+    };
+    const ShaderRegistry::ProgramRequest lightCubeRequest = requestProgram({{"LIGHT_SOURCE"}});
+    const ShaderRegistry::ProgramRequest lightingRequest = requestProgram({{"INSTANCED"}});
+    const ShaderRegistry::ProgramRequest textureRequest = requestProgram({{"INSTANCED"}, {"TEXTURED"}});
 
-    GLuint VBO, textureInfoVBO, cubeVAO;
+    GLuint VBO, textureInfoVBO;
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &textureInfoVBO);
-    glGenVertexArrays(1, &cubeVAO);
-
-    glBindVertexArray(cubeVAO);
-
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
     glBindBuffer(GL_ARRAY_BUFFER, textureInfoVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(textureCoordinates), textureCoordinates, GL_STATIC_DRAW);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
+
+    // The cube is drawn both with and without instancing. Every InstancedRenderer adds its own attributes to its vertex
+    // array object, so they each get one. They all use the same vertex buffers.
+    const auto createCubeVAO = [VBO, textureInfoVBO]() -> GLuint {
+        GLuint vao;
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, textureInfoVBO);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(1);
+        return vao;
+    };
+    GLuint cubeVAO = createCubeVAO();
+    GLuint coloredCubesVAO = createCubeVAO();
+    GLuint textureCubesVAO = createCubeVAO();
+    InstancedRenderer coloredCubes(coloredCubesVAO, 36);
+    InstancedRenderer textureCubes(textureCubesVAO, 36);
 
     Texture2D containerTexture = Texture2D("textures/container.jpg");
-    textureShader.use();
-    textureShader.setUniform1i("ourTexture", 0);
+
+    const auto getProgram = [&shaderRegistry](const ShaderRegistry::ProgramRequest &request, const char *name) {
+        try {
+            return shaderRegistry.getProgram(request);
+        } catch (const std::runtime_error &e) {
+            std::cerr << "An error occured during construction of OpenGL shader " << name << ": " << e.what();
+            std::exit(EXIT_FAILURE);
+        }
+    };
+    const std::shared_ptr<const ShaderProgram> lightCubeShader = getProgram(lightCubeRequest, "lightSourceShader");
+    const std::shared_ptr<const ShaderProgram> lightingShader = getProgram(lightingRequest, "lightingShader");
+    const std::shared_ptr<const ShaderProgram> textureShader = getProgram(textureRequest, "textureShader");
+    textureShader->use();
+    textureShader->setUniform1i("ourTexture", 0);
+
+    const UniformHandle<Vector3> objectColor = lightingShader->getUniform<Vector3>("objectColor");
+    const UniformHandle<Vector3> lightColor = lightingShader->getUniform<Vector3>("lightColor");
+    const UniformHandle<ColumnMajorMatrix4> lightCubeModelUniform = lightCubeShader->getUniform<ColumnMajorMatrix4>("model");
 
     ViewMatrix viewMatrix;
     viewMatrix.registerWithGlfwWindow(window);
     GlfwWindow::WindowSize wSize = window.getWindowSize();
     PerspectiveProjectionMatrix projectionMatrix(DEGREES_TO_RADIANS(45.0), wSize.width, wSize.height, 0.1, 100);
     OpenGlMatrix lightCubeModel;
-    OpenGlMatrix cubeModel;
-    OpenGlMatrix textureCubeModel;
+    std::vector<OpenGlMatrix> cubeModels(1);
+    std::vector<OpenGlMatrix> textureCubeModels(1);
     lightCubeModel.setScale(0.2, 0.2, 0.2);
     lightCubeModel.setTranslate(1.2, 1.0, 2.0);
-    textureCubeModel.setTranslate(2.0, 0.0, 0.0);
+    textureCubeModels[0].setTranslate(2.0, 0.0, 0.0);
     projectionMatrix.registerGlfwWindow(window);
 
-    TextRenderer tRen = TextRenderer("serif", 0, 24);
+    TextRenderer tRen = TextRenderer(shaderRegistry, "", 0, 24);
+#ifdef DEBUG
+    shaderRegistry.writeStatistics(std::cerr);
+#endif
     OrthographicProjectionMatrix ortMat = OrthographicProjectionMatrix(0, wSize.width, 0, wSize.height, -50, 50);
     ortMat.registerGlfwWindow(window);
+    CameraUniformBuffer camera;
 
     const GLubyte *vendor = glGetString(GL_VENDOR);
     const GLubyte *renderer = glGetString(GL_RENDERER);
+    std::ostringstream rendererInfoStream;
+    rendererInfoStream << "GL_VENDOR: " << vendor << "\n";
+    rendererInfoStream << "GL_RENDERER: " << renderer << "\n";
+    const std::string rendererInfoText = rendererInfoStream.str();
+    TextBlock rendererInfo(tRen);
 
     float lastTime = glfwGetTime();
     while(!window.shouldClose()) {
@@ -196,33 +227,26 @@ int main() {
 
         // Update the viewMatrix
         viewMatrix.update();
-        // Draw the colored cube
-        lightingShader.use();
-        lightingShader.setUniform3f("objectColor", 1.0, 0.5, 0.31);
-        lightingShader.setUniform3f("lightColor", 1, 1, 1);
-        lightingShader.setUniformMatrix4v("model", 1, true, cubeModel.data());
-        lightingShader.setUniformMatrix4v("view", 1, true, viewMatrix.data());
-        lightingShader.setUniformMatrix4v("projection", 1, true, projectionMatrix.data());
-        glBindVertexArray(cubeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        camera.update(viewMatrix, projectionMatrix, ortMat);
+        // Draw the colored cubes
+        lightingShader->use();
+        objectColor.set(Vector3(1.0, 0.5, 0.31));
+        lightColor.set(Vector3(1, 1, 1));
+        coloredCubes.setInstances(cubeModels);
+        coloredCubes.draw();
 
         // Draw the light cube
-        lightCubeShader.use();
-        lightingShader.setUniformMatrix4v("model", 1, true, lightCubeModel.data());
-        lightingShader.setUniformMatrix4v("view", 1, true, viewMatrix.data());
-        lightingShader.setUniformMatrix4v("projection", 1, true, projectionMatrix.data());
+        lightCubeShader->use();
+        lightCubeModelUniform.setData(lightCubeModel.columnMajorData());
         glBindVertexArray(cubeVAO);
         glDrawArrays(GL_TRIANGLES, 0, 36);
 
-        // Draw the textured cube
-        textureShader.use();
-        textureShader.setUniformMatrix4v("model", 1, true, textureCubeModel.data());
-        textureShader.setUniformMatrix4v("view", 1, true, viewMatrix.data());
-        textureShader.setUniformMatrix4v("projection", 1, true, projectionMatrix.data());
+        // Draw the textured cubes
+        textureShader->use();
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, containerTexture.getTextureId());
-        glBindVertexArray(cubeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        textureCubes.setInstances(textureCubeModels);
+        textureCubes.draw();
 
         const GlfwWindow::WindowSize size = window.getWindowSize();
         const struct GlfwWindow::CursorPosition cPos = window.getCursorPosition();
@@ -232,28 +256,38 @@ int main() {
         lastTime = curTime;
         float fps = 1/timeDiff;
 
+        // What the text took to draw in the previous frame.
+        const TextRenderer::DrawStatistics textStatistics = tRen.getDrawStatistics();
+        tRen.resetDrawStatistics();
+
         std::ostringstream stream;
         stream << "Mouse cursor position: (" << cPos.xpos << ", " << cPos.ypos << ")" << ".\n";
         stream << "Window has focus: " << (hasFocus ? "yes" : "no") << ".\n";
         stream << "Current FPS: " << fps << ".\n";
-        tRen.renderText(ortMat, stream.str(), 0, size.height, 1.0f, 0, TextRenderer::VerticalAlignment::top,
+        stream << "Text: " << textStatistics.glyphs << " glyphs in " << textStatistics.drawCalls << " draw calls, "
+               << textStatistics.bufferUploads << " uploads.\n";
+        const LineLayoutCache::Statistics &layoutStatistics = tRen.getLayoutCacheStatistics();
+        stream << "Layout cache: " << layoutStatistics.hits << " hits, " << layoutStatistics.misses << " misses.\n";
+        const GlyphCache::Statistics &glyphStatistics = tRen.getGlyphCacheStatistics();
+        stream << "Glyph cache: " << glyphStatistics.residentGlyphs << " glyphs in " << glyphStatistics.pagesInUse << "/"
+               << glyphStatistics.pageCount << " pages, " << glyphStatistics.usedTexels * 100 / glyphStatistics.totalTexels
+               << "% full, " << glyphStatistics.pageEvictions << " evictions.\n";
+        tRen.renderText(stream.str(), 0, size.height, 1.0f, 0, TextRenderer::VerticalAlignment::top,
                         TextRenderer::HorizontalAlignment::left,
                         Vector3(1.0, 1.0, 1.0), true,
                         Vector3());
 
-        stream.str(std::string());
-        stream << "GL_VENDOR: " << vendor << "\n";
-        stream << "GL_RENDERER: " << renderer << "\n";
-        tRen.renderText(ortMat, stream.str(), size.width, size.height, 1.0f, size.width/2,
-                        TextRenderer::VerticalAlignment::top,
-                        TextRenderer::HorizontalAlignment::right,
-                        Vector3(1.0, 1.0, 1.0), true,
-                        Vector3());
+        // Only laid out again when the window width changes.
+        rendererInfo.setText(rendererInfoText, 1.0f, size.width/2, TextRenderer::VerticalAlignment::top,
+                             TextRenderer::HorizontalAlignment::right, Vector3(1.0, 1.0, 1.0), true, Vector3());
+        rendererInfo.draw(size.width, size.height);
 
         window.swapBuffers();
         glfwPollEvents();
     }
     glDeleteVertexArrays(1, &cubeVAO);
+    glDeleteVertexArrays(1, &coloredCubesVAO);
+    glDeleteVertexArrays(1, &textureCubesVAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &textureInfoVBO);
     glfwTerminate();
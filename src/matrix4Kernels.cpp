@@ -0,0 +1,500 @@
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MATRIX4_KERNELS_X86
+#endif
+
+#include "matrix4Kernels.hpp"
+
+// The scalar reference implementation. The SIMD implementations below must perform the same operations in the same
+// order, see the precision remarks in matrix4Kernels.hpp.
+static void multiplyScalar(const float* lhs, const float* rhs, float* out)
+{
+    float res[16];
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            float sum = lhs[i*4] * rhs[j];
+            for (std::size_t k = 1; k < 4; ++k) {
+                sum += lhs[i*4 + k] * rhs[k*4 + j];
+            }
+            res[i*4 + j] = sum;
+        }
+    }
+    for (std::size_t i = 0; i < 16; ++i) {
+        out[i] = res[i];
+    }
+}
+
+static void multiplyVectorScalar(const float* mat, const float* vec, float* out)
+{
+    float res[4];
+    for (std::size_t i = 0; i < 4; ++i) {
+        float sum = mat[i*4] * vec[0];
+        for (std::size_t k = 1; k < 4; ++k) {
+            sum += mat[i*4 + k] * vec[k];
+        }
+        res[i] = sum;
+    }
+    for (std::size_t i = 0; i < 4; ++i) {
+        out[i] = res[i];
+    }
+}
+
+// Cramer's rule: the inverse is the transposed cofactor matrix divided by the determinant. The 2x2 minors of the
+// upper and lower two rows are shared by the cofactors.
+static bool inverseScalar(const float* m, float* out)
+{
+    const float s0 = m[0] * m[5] - m[1] * m[4];
+    const float s1 = m[0] * m[6] - m[2] * m[4];
+    const float s2 = m[0] * m[7] - m[3] * m[4];
+    const float s3 = m[1] * m[6] - m[2] * m[5];
+    const float s4 = m[1] * m[7] - m[3] * m[5];
+    const float s5 = m[2] * m[7] - m[3] * m[6];
+    const float c5 = m[10] * m[15] - m[11] * m[14];
+    const float c4 = m[9] * m[15] - m[11] * m[13];
+    const float c3 = m[9] * m[14] - m[10] * m[13];
+    const float c2 = m[8] * m[15] - m[11] * m[12];
+    const float c1 = m[8] * m[14] - m[10] * m[12];
+    const float c0 = m[8] * m[13] - m[9] * m[12];
+    const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if (det == 0)
+        return false;
+    const float invDet = 1 / det;
+    float res[16] = {
+        ( m[5] * c5 - m[6] * c4 + m[7] * c3) * invDet,
+        (-m[1] * c5 + m[2] * c4 - m[3] * c3) * invDet,
+        ( m[13] * s5 - m[14] * s4 + m[15] * s3) * invDet,
+        (-m[9] * s5 + m[10] * s4 - m[11] * s3) * invDet,
+
+        (-m[4] * c5 + m[6] * c2 - m[7] * c1) * invDet,
+        ( m[0] * c5 - m[2] * c2 + m[3] * c1) * invDet,
+        (-m[12] * s5 + m[14] * s2 - m[15] * s1) * invDet,
+        ( m[8] * s5 - m[10] * s2 + m[11] * s1) * invDet,
+
+        ( m[4] * c4 - m[5] * c2 + m[7] * c0) * invDet,
+        (-m[0] * c4 + m[1] * c2 - m[3] * c0) * invDet,
+        ( m[12] * s4 - m[13] * s2 + m[15] * s0) * invDet,
+        (-m[8] * s4 + m[9] * s2 - m[11] * s0) * invDet,
+
+        (-m[4] * c3 + m[5] * c1 - m[6] * c0) * invDet,
+        ( m[0] * c3 - m[1] * c1 + m[2] * c0) * invDet,
+        (-m[12] * s3 + m[13] * s1 - m[14] * s0) * invDet,
+        ( m[8] * s3 - m[9] * s1 + m[10] * s0) * invDet,
+    };
+    for (std::size_t i = 0; i < 16; ++i) {
+        out[i] = res[i];
+    }
+    return true;
+}
+
+// Also used by the SIMD implementations to process the points that do not fill a complete register.
+static inline void transformPointArraysRange(const float* m, const Matrix4Kernels::ConstPointArrays& in,
+                                             const Matrix4Kernels::PointArrays& out,
+                                             const std::size_t begin, const std::size_t end)
+{
+    for (std::size_t i = begin; i < end; ++i) {
+        const float x = in.x[i];
+        const float y = in.y[i];
+        const float z = in.z[i];
+        const float w = in.w == nullptr ? 1.0f : in.w[i];
+        out.x[i] = m[0] * x + m[1] * y + m[2] * z + m[3] * w;
+        out.y[i] = m[4] * x + m[5] * y + m[6] * z + m[7] * w;
+        out.z[i] = m[8] * x + m[9] * y + m[10] * z + m[11] * w;
+        if (out.w != nullptr)
+            out.w[i] = m[12] * x + m[13] * y + m[14] * z + m[15] * w;
+    }
+}
+
+static void transformPointArraysScalar(const float* mat, const Matrix4Kernels::ConstPointArrays& in,
+                                       const Matrix4Kernels::PointArrays& out, const std::size_t count)
+{
+    transformPointArraysRange(mat, in, out, 0, count);
+}
+
+static void transformPointsScalar(const float* mat, const float* in, float* out, const std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        multiplyVectorScalar(mat, in + i*4, out + i*4);
+    }
+}
+
+#ifdef MATRIX4_KERNELS_X86
+// Row i of the result is the sum over k of lhs[i][k] * (row k of rhs).
+// All rows of rhs are loaded before anything is stored, so out may alias rhs. Row i of out is only written after row i
+// of lhs has been read, so out may alias lhs as well.
+__attribute__((target("sse2")))
+static void multiplySse2(const float* lhs, const float* rhs, float* out)
+{
+    const __m128 r0 = _mm_loadu_ps(rhs);
+    const __m128 r1 = _mm_loadu_ps(rhs + 4);
+    const __m128 r2 = _mm_loadu_ps(rhs + 8);
+    const __m128 r3 = _mm_loadu_ps(rhs + 12);
+    for (std::size_t i = 0; i < 4; ++i) {
+        const __m128 a = _mm_loadu_ps(lhs + i*4);
+        __m128 acc = _mm_mul_ps(_mm_shuffle_ps(a, a, 0x00), r0);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(a, a, 0x55), r1));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(a, a, 0xAA), r2));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(a, a, 0xFF), r3));
+        _mm_storeu_ps(out + i*4, acc);
+    }
+}
+
+// Transposing the matrix turns the four dot products into a sum of scaled columns, which keeps the order of the
+// additions equal to the scalar implementation.
+__attribute__((target("sse2")))
+static void multiplyVectorSse2(const float* mat, const float* vec, float* out)
+{
+    __m128 c0 = _mm_loadu_ps(mat);
+    __m128 c1 = _mm_loadu_ps(mat + 4);
+    __m128 c2 = _mm_loadu_ps(mat + 8);
+    __m128 c3 = _mm_loadu_ps(mat + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    const __m128 v = _mm_loadu_ps(vec);
+    __m128 acc = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00));
+    acc = _mm_add_ps(acc, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xAA)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xFF)));
+    _mm_storeu_ps(out, acc);
+}
+
+// The 2x2 matrices below are stored row based in one register: (a, b, c, d) is the matrix | a b |
+//                                                                                        | c d |
+static constexpr int shuffleMask(const int x, const int y, const int z, const int w)
+{
+    return x | (y << 2) | (z << 4) | (w << 6);
+}
+
+// A * B
+__attribute__((target("sse2")))
+static inline __m128 mat2Multiply(const __m128 a, const __m128 b)
+{
+    return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, shuffleMask(0, 3, 0, 3))),
+                      _mm_mul_ps(_mm_shuffle_ps(a, a, shuffleMask(1, 0, 3, 2)), _mm_shuffle_ps(b, b, shuffleMask(2, 1, 2, 1))));
+}
+
+// adjugate(A) * B
+__attribute__((target("sse2")))
+static inline __m128 mat2AdjugateMultiply(const __m128 a, const __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, shuffleMask(3, 3, 0, 0)), b),
+                      _mm_mul_ps(_mm_shuffle_ps(a, a, shuffleMask(1, 1, 2, 2)), _mm_shuffle_ps(b, b, shuffleMask(2, 3, 0, 1))));
+}
+
+// A * adjugate(B)
+__attribute__((target("sse2")))
+static inline __m128 mat2MultiplyAdjugate(const __m128 a, const __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, shuffleMask(3, 0, 3, 0))),
+                      _mm_mul_ps(_mm_shuffle_ps(a, a, shuffleMask(1, 0, 3, 2)), _mm_shuffle_ps(b, b, shuffleMask(2, 1, 2, 1))));
+}
+
+// Blockwise inversion: the matrix is split into the 2x2 blocks | A B |, which are inverted using 2x2 adjugates.
+//                                                              | C D |
+__attribute__((target("sse2")))
+static bool inverseSse2(const float* mat, float* out)
+{
+    const __m128 r0 = _mm_loadu_ps(mat);
+    const __m128 r1 = _mm_loadu_ps(mat + 4);
+    const __m128 r2 = _mm_loadu_ps(mat + 8);
+    const __m128 r3 = _mm_loadu_ps(mat + 12);
+    const __m128 a = _mm_movelh_ps(r0, r1);
+    const __m128 b = _mm_movehl_ps(r1, r0);
+    const __m128 c = _mm_movelh_ps(r2, r3);
+    const __m128 d = _mm_movehl_ps(r3, r2);
+
+    // The determinants of the blocks: (|A|, |B|, |C|, |D|)
+    const __m128 detSub = _mm_sub_ps(
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, shuffleMask(0, 2, 0, 2)), _mm_shuffle_ps(r1, r3, shuffleMask(1, 3, 1, 3))),
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, shuffleMask(1, 3, 1, 3)), _mm_shuffle_ps(r1, r3, shuffleMask(0, 2, 0, 2))));
+    const __m128 detA = _mm_shuffle_ps(detSub, detSub, shuffleMask(0, 0, 0, 0));
+    const __m128 detB = _mm_shuffle_ps(detSub, detSub, shuffleMask(1, 1, 1, 1));
+    const __m128 detC = _mm_shuffle_ps(detSub, detSub, shuffleMask(2, 2, 2, 2));
+    const __m128 detD = _mm_shuffle_ps(detSub, detSub, shuffleMask(3, 3, 3, 3));
+
+    // The inverse is 1/|M| * | X Y |, where the blocks are computed as adjugates first.
+    //                        | Z W |
+    const __m128 dc = mat2AdjugateMultiply(d, c);
+    const __m128 ab = mat2AdjugateMultiply(a, b);
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mat2Multiply(b, dc));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mat2Multiply(c, ab));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mat2MultiplyAdjugate(d, ab));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mat2MultiplyAdjugate(a, dc));
+
+    // |M| = |A| * |D| + |B| * |C| - trace(adjugate(A) * B * adjugate(D) * C)
+    __m128 tr = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, shuffleMask(0, 2, 1, 3)));
+    tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+    tr = _mm_add_ss(tr, _mm_shuffle_ps(tr, tr, shuffleMask(1, 1, 1, 1)));
+    const __m128 detM = _mm_sub_ss(_mm_add_ss(_mm_mul_ss(detA, detD), _mm_mul_ss(detB, detC)), tr);
+    if (_mm_cvtss_f32(detM) == 0)
+        return false;
+
+    // (1/|M|, -1/|M|, -1/|M|, 1/|M|): the signs turn the block adjugates into the blocks of the adjugate.
+    const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), _mm_shuffle_ps(detM, detM, 0x00));
+    x = _mm_mul_ps(x, rDetM);
+    y = _mm_mul_ps(y, rDetM);
+    z = _mm_mul_ps(z, rDetM);
+    w = _mm_mul_ps(w, rDetM);
+
+    // Transpose the 2x2 adjugates while storing.
+    _mm_storeu_ps(out, _mm_shuffle_ps(x, y, shuffleMask(3, 1, 3, 1)));
+    _mm_storeu_ps(out + 4, _mm_shuffle_ps(x, y, shuffleMask(2, 0, 2, 0)));
+    _mm_storeu_ps(out + 8, _mm_shuffle_ps(z, w, shuffleMask(3, 1, 3, 1)));
+    _mm_storeu_ps(out + 12, _mm_shuffle_ps(z, w, shuffleMask(2, 0, 2, 0)));
+    return true;
+}
+
+// Four points per iteration: every register holds the same coordinate of four consecutive points.
+__attribute__((target("sse2")))
+static void transformPointArraysSse2(const float* mat, const Matrix4Kernels::ConstPointArrays& in,
+                                     const Matrix4Kernels::PointArrays& out, const std::size_t count)
+{
+    __m128 m[16];
+    for (std::size_t i = 0; i < 16; ++i) {
+        m[i] = _mm_set1_ps(mat[i]);
+    }
+    const __m128 one = _mm_set1_ps(1.0f);
+    const std::size_t simdCount = count - count % 4;
+    for (std::size_t i = 0; i < simdCount; i += 4) {
+        const __m128 x = _mm_loadu_ps(in.x + i);
+        const __m128 y = _mm_loadu_ps(in.y + i);
+        const __m128 z = _mm_loadu_ps(in.z + i);
+        const __m128 w = in.w == nullptr ? one : _mm_loadu_ps(in.w + i);
+        for (std::size_t row = 0; row < 4; ++row) {
+            float* dst = row == 0 ? out.x : row == 1 ? out.y : row == 2 ? out.z : out.w;
+            if (dst == nullptr)
+                continue;
+            __m128 acc = _mm_mul_ps(m[row*4], x);
+            acc = _mm_add_ps(acc, _mm_mul_ps(m[row*4 + 1], y));
+            acc = _mm_add_ps(acc, _mm_mul_ps(m[row*4 + 2], z));
+            acc = _mm_add_ps(acc, _mm_mul_ps(m[row*4 + 3], w));
+            _mm_storeu_ps(dst + i, acc);
+        }
+    }
+    transformPointArraysRange(mat, in, out, simdCount, count);
+}
+
+__attribute__((target("sse2")))
+static void transformPointsSse2(const float* mat, const float* in, float* out, const std::size_t count)
+{
+    __m128 c0 = _mm_loadu_ps(mat);
+    __m128 c1 = _mm_loadu_ps(mat + 4);
+    __m128 c2 = _mm_loadu_ps(mat + 8);
+    __m128 c3 = _mm_loadu_ps(mat + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    for (std::size_t i = 0; i < count; ++i) {
+        const __m128 v = _mm_loadu_ps(in + i*4);
+        __m128 acc = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00));
+        acc = _mm_add_ps(acc, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xAA)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xFF)));
+        _mm_storeu_ps(out + i*4, acc);
+    }
+}
+
+// A single vector does not fill a 256 bit register, but the VEX encoded 128 bit instructions avoid the SSE/AVX
+// transition penalty.
+__attribute__((target("avx")))
+static void multiplyVectorAvx(const float* mat, const float* vec, float* out)
+{
+    __m128 c0 = _mm_loadu_ps(mat);
+    __m128 c1 = _mm_loadu_ps(mat + 4);
+    __m128 c2 = _mm_loadu_ps(mat + 8);
+    __m128 c3 = _mm_loadu_ps(mat + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    const __m128 v = _mm_loadu_ps(vec);
+    __m128 acc = _mm_mul_ps(c0, _mm_permute_ps(v, 0x00));
+    acc = _mm_add_ps(acc, _mm_mul_ps(c1, _mm_permute_ps(v, 0x55)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(c2, _mm_permute_ps(v, 0xAA)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(c3, _mm_permute_ps(v, 0xFF)));
+    _mm_storeu_ps(out, acc);
+}
+
+// Eight points per iteration, see transformPointArraysSse2.
+__attribute__((target("avx")))
+static void transformPointArraysAvx(const float* mat, const Matrix4Kernels::ConstPointArrays& in,
+                                    const Matrix4Kernels::PointArrays& out, const std::size_t count)
+{
+    __m256 m[16];
+    for (std::size_t i = 0; i < 16; ++i) {
+        m[i] = _mm256_set1_ps(mat[i]);
+    }
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const std::size_t simdCount = count - count % 8;
+    for (std::size_t i = 0; i < simdCount; i += 8) {
+        const __m256 x = _mm256_loadu_ps(in.x + i);
+        const __m256 y = _mm256_loadu_ps(in.y + i);
+        const __m256 z = _mm256_loadu_ps(in.z + i);
+        const __m256 w = in.w == nullptr ? one : _mm256_loadu_ps(in.w + i);
+        for (std::size_t row = 0; row < 4; ++row) {
+            float* dst = row == 0 ? out.x : row == 1 ? out.y : row == 2 ? out.z : out.w;
+            if (dst == nullptr)
+                continue;
+            __m256 acc = _mm256_mul_ps(m[row*4], x);
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(m[row*4 + 1], y));
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(m[row*4 + 2], z));
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(m[row*4 + 3], w));
+            _mm256_storeu_ps(dst + i, acc);
+        }
+    }
+    transformPointArraysRange(mat, in, out, simdCount, count);
+}
+
+// Two points per iteration, one per lane. The columns of the matrix are duplicated into both lanes.
+__attribute__((target("avx")))
+static void transformPointsAvx(const float* mat, const float* in, float* out, const std::size_t count)
+{
+    __m128 c0 = _mm_loadu_ps(mat);
+    __m128 c1 = _mm_loadu_ps(mat + 4);
+    __m128 c2 = _mm_loadu_ps(mat + 8);
+    __m128 c3 = _mm_loadu_ps(mat + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    const __m256 col0 = _mm256_set_m128(c0, c0);
+    const __m256 col1 = _mm256_set_m128(c1, c1);
+    const __m256 col2 = _mm256_set_m128(c2, c2);
+    const __m256 col3 = _mm256_set_m128(c3, c3);
+    const std::size_t simdCount = count - count % 2;
+    for (std::size_t i = 0; i < simdCount; i += 2) {
+        const __m256 v = _mm256_loadu_ps(in + i*4);
+        __m256 acc = _mm256_mul_ps(col0, _mm256_permute_ps(v, 0x00));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(col1, _mm256_permute_ps(v, 0x55)));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(col2, _mm256_permute_ps(v, 0xAA)));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(col3, _mm256_permute_ps(v, 0xFF)));
+        _mm256_storeu_ps(out + i*4, acc);
+    }
+    if (simdCount != count)
+        multiplyVectorAvx(mat, in + simdCount*4, out + simdCount*4);
+}
+
+__attribute__((target("avx,fma")))
+static void multiplyVectorAvxFma(const float* mat, const float* vec, float* out)
+{
+    __m128 c0 = _mm_loadu_ps(mat);
+    __m128 c1 = _mm_loadu_ps(mat + 4);
+    __m128 c2 = _mm_loadu_ps(mat + 8);
+    __m128 c3 = _mm_loadu_ps(mat + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    const __m128 v = _mm_loadu_ps(vec);
+    __m128 acc = _mm_mul_ps(c0, _mm_permute_ps(v, 0x00));
+    acc = _mm_fmadd_ps(c1, _mm_permute_ps(v, 0x55), acc);
+    acc = _mm_fmadd_ps(c2, _mm_permute_ps(v, 0xAA), acc);
+    acc = _mm_fmadd_ps(c3, _mm_permute_ps(v, 0xFF), acc);
+    _mm_storeu_ps(out, acc);
+}
+
+__attribute__((target("avx,fma")))
+static void transformPointArraysAvxFma(const float* mat, const Matrix4Kernels::ConstPointArrays& in,
+                                       const Matrix4Kernels::PointArrays& out, const std::size_t count)
+{
+    __m256 m[16];
+    for (std::size_t i = 0; i < 16; ++i) {
+        m[i] = _mm256_set1_ps(mat[i]);
+    }
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const std::size_t simdCount = count - count % 8;
+    for (std::size_t i = 0; i < simdCount; i += 8) {
+        const __m256 x = _mm256_loadu_ps(in.x + i);
+        const __m256 y = _mm256_loadu_ps(in.y + i);
+        const __m256 z = _mm256_loadu_ps(in.z + i);
+        const __m256 w = in.w == nullptr ? one : _mm256_loadu_ps(in.w + i);
+        for (std::size_t row = 0; row < 4; ++row) {
+            float* dst = row == 0 ? out.x : row == 1 ? out.y : row == 2 ? out.z : out.w;
+            if (dst == nullptr)
+                continue;
+            __m256 acc = _mm256_mul_ps(m[row*4], x);
+            acc = _mm256_fmadd_ps(m[row*4 + 1], y, acc);
+            acc = _mm256_fmadd_ps(m[row*4 + 2], z, acc);
+            acc = _mm256_fmadd_ps(m[row*4 + 3], w, acc);
+            _mm256_storeu_ps(dst + i, acc);
+        }
+    }
+    transformPointArraysRange(mat, in, out, simdCount, count);
+}
+
+__attribute__((target("avx,fma")))
+static void transformPointsAvxFma(const float* mat, const float* in, float* out, const std::size_t count)
+{
+    __m128 c0 = _mm_loadu_ps(mat);
+    __m128 c1 = _mm_loadu_ps(mat + 4);
+    __m128 c2 = _mm_loadu_ps(mat + 8);
+    __m128 c3 = _mm_loadu_ps(mat + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    const __m256 col0 = _mm256_set_m128(c0, c0);
+    const __m256 col1 = _mm256_set_m128(c1, c1);
+    const __m256 col2 = _mm256_set_m128(c2, c2);
+    const __m256 col3 = _mm256_set_m128(c3, c3);
+    const std::size_t simdCount = count - count % 2;
+    for (std::size_t i = 0; i < simdCount; i += 2) {
+        const __m256 v = _mm256_loadu_ps(in + i*4);
+        __m256 acc = _mm256_mul_ps(col0, _mm256_permute_ps(v, 0x00));
+        acc = _mm256_fmadd_ps(col1, _mm256_permute_ps(v, 0x55), acc);
+        acc = _mm256_fmadd_ps(col2, _mm256_permute_ps(v, 0xAA), acc);
+        acc = _mm256_fmadd_ps(col3, _mm256_permute_ps(v, 0xFF), acc);
+        _mm256_storeu_ps(out + i*4, acc);
+    }
+    if (simdCount != count)
+        multiplyVectorAvxFma(mat, in + simdCount*4, out + simdCount*4);
+}
+#endif //MATRIX4_KERNELS_X86
+
+namespace Matrix4Kernels {
+    // The 4x4 multiply of the AVX sets is the SSE2 one: it measured faster than two rows per 256 bit register, whose
+    // loads cannot be forwarded from the narrower stores that usually just wrote the matrix.
+    static const KernelSet kernelSets[] = {
+        {InstructionSet::scalar, "scalar", multiplyScalar, multiplyVectorScalar, inverseScalar,
+         transformPointArraysScalar, transformPointsScalar},
+#ifdef MATRIX4_KERNELS_X86
+        {InstructionSet::sse2, "sse2", multiplySse2, multiplyVectorSse2, inverseSse2,
+         transformPointArraysSse2, transformPointsSse2},
+        {InstructionSet::avx, "avx", multiplySse2, multiplyVectorAvx, inverseSse2,
+         transformPointArraysAvx, transformPointsAvx},
+        {InstructionSet::avxFma, "avx+fma", multiplySse2, multiplyVectorAvxFma, inverseSse2,
+         transformPointArraysAvxFma, transformPointsAvxFma},
+#endif
+    };
+
+    bool isSupported(const InstructionSet instructionSet) noexcept
+    {
+        switch (instructionSet) {
+            case InstructionSet::scalar:
+                return true;
+#ifdef MATRIX4_KERNELS_X86
+            // __builtin_cpu_supports uses CPUID, and also verifies that the OS saves the AVX registers.
+            case InstructionSet::sse2:
+                return __builtin_cpu_supports("sse2");
+            case InstructionSet::avx:
+                return __builtin_cpu_supports("avx");
+            case InstructionSet::avxFma:
+                return __builtin_cpu_supports("avx") && __builtin_cpu_supports("fma");
+#endif
+            default:
+                return false;
+        }
+    }
+
+    const KernelSet& get(const InstructionSet instructionSet)
+    {
+        if (isSupported(instructionSet)) {
+            for (const KernelSet& kernelSet : kernelSets) {
+                if (kernelSet.instructionSet == instructionSet)
+                    return kernelSet;
+            }
+        }
+        throw std::runtime_error("Matrix4Kernels: the requested instruction set is not supported");
+    }
+
+    const KernelSet& active(void) noexcept
+    {
+        static const KernelSet& selected = []() -> const KernelSet& {
+            // kernelSets is ordered by register width, and every set uses the kernels that measured fastest among
+            // those the instruction set allows, so the widest supported set is the one to use.
+            const KernelSet* best = &kernelSets[0];
+            for (const KernelSet& kernelSet : kernelSets) {
+                if (isSupported(kernelSet.instructionSet))
+                    best = &kernelSet;
+            }
+            return *best;
+        }();
+        return selected;
+    }
+}
@@ -1,32 +1,45 @@
-#include <cmath>
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
 
 #include "openglMatrix.hpp"
 
-Matrix4 OpenGlMatrix::toRotationMatrix(const Vector3 &vec) const
+std::uint64_t OpenGlMatrix::Version::next(void) noexcept
 {
-    float x = vec.x();
-    float y = vec.y();
-    float z = vec.z();
-    return Matrix4({
-        std::cos(y)*std::cos(z),                        std::cos(y)*std::sin(z),                        -std::sin(y),       0,
-        std::sin(x)*std::sin(y)*std::cos(z) - std::cos(x)*std::sin(z), std::sin(x)*std::sin(y)*std::sin(z) + std::cos(x)*std::cos(z), std::sin(x)*std::cos(y), 0,
-        std::cos(x)*std::sin(y)*std::cos(z) + std::sin(x)*std::sin(z), std::cos(x)*std::sin(y)*std::sin(z) - std::sin(x)*std::cos(z), std::cos(x)*std::cos(y), 0,
-        0,                                    0,                                    0,             1,
-    });
+    // Starts at 1, so no version is 0.
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+OpenGlMatrix::Version::Version(void) noexcept :
+    value(next())
+{}
+
+OpenGlMatrix::Version::Version(const Version&) noexcept :
+    value(next())
+{}
 
+OpenGlMatrix::Version& OpenGlMatrix::Version::operator=(const Version&) noexcept
+{
+    this->value = next();
+    return *this;
 }
 
-Matrix4 OpenGlMatrix::toTranslationMatrix(const Vector3 &vec) const
+void OpenGlMatrix::Version::advance(void) noexcept
 {
-    float x = vec.x();
-    float y = vec.y();
-    float z = vec.z();
-    return Matrix4({
-        1, 0, 0, x,
-        0, 1, 0, y,
-        0, 0, 1, z,
-        0, 0, 0, 1,
-    });
+    this->value = next();
+}
+
+std::uint64_t OpenGlMatrix::Version::get(void) const noexcept
+{
+    return this->value;
+}
+
+Quaternion OpenGlMatrix::toRotation(const float x, const float y, const float z) const
+{
+    // The angles have always been interpreted as the inverse (transposed) rotation of the conventional x, then y,
+    // then z rotation.
+    return Quaternion::conjugate(Quaternion::fromEulerAngles(x, y, z));
 }
 
 Matrix4 OpenGlMatrix::toScaleMatrix(const Vector3 &vec) const
@@ -42,77 +55,196 @@ Matrix4 OpenGlMatrix::toScaleMatrix(const Vector3 &vec) const
     });
 }
 
-Matrix4 OpenGlMatrix::getCombinedMatrix(void) const
+void OpenGlMatrix::markDirty(const unsigned components)
+{
+    this->dirtyComponents |= components;
+    this->inverseValid = false;
+    this->version.advance();
+}
+
+Matrix4 OpenGlMatrix::getCombinedMatrix(void)
 {
-    // scale, rotate, translate
-    // Default constructor creates identity matrix.
-    Matrix4 mat4;
-    mat4 *= toTranslationMatrix(this->translation);
-    mat4 *= toRotationMatrix(this->rotation);
-    mat4 *= toScaleMatrix(this->scaling);
-    mat4 *= toRotationMatrix(this->lateRotation);
-    return mat4;
+    // translate * rotate * scale * lateRotate.
+    // Translating only fills in the last column, so the other three are cached and only recomputed if they changed.
+    if (this->dirtyComponents & (rotationComponent | scalingComponent | lateRotationComponent)) {
+        this->linearMat = this->rotation.toMatrix4() * toScaleMatrix(this->scaling) * this->lateRotation.toMatrix4();
+    }
+    std::array<float, 16> combined;
+    for (std::size_t i = 0; i < combined.size(); ++i) {
+        combined[i] = this->linearMat[i];
+    }
+    combined[3] = this->translation.x();
+    combined[7] = this->translation.y();
+    combined[11] = this->translation.z();
+    return Matrix4(combined);
+}
+
+Matrix4 OpenGlMatrix::getInverseMatrix(void) const
+{
+    // (translate * rotate * scale * lateRotate)^-1 = lateRotate^-1 * scale^-1 * rotate^-1 * translate^-1.
+    // The inverse rotations are the conjugates and the inverse scaling is the reciprocal, so nothing has to be solved.
+    if (this->scaling.x() == 0 || this->scaling.y() == 0 || this->scaling.z() == 0) {
+        std::ostringstream errorMessage;
+        errorMessage << "Cannot invert a model matrix with scaling (" << this->scaling.x() << ", "
+                     << this->scaling.y() << ", " << this->scaling.z() << ")";
+        throw std::runtime_error(errorMessage.str());
+    }
+    const Vector3 inverseScaling(1 / this->scaling.x(), 1 / this->scaling.y(), 1 / this->scaling.z());
+    const Matrix4 linearInverse = Quaternion::conjugate(this->lateRotation).toMatrix4() * toScaleMatrix(inverseScaling)
+                                  * Quaternion::conjugate(this->rotation).toMatrix4();
+    // The translation column becomes -linearInverse * translation.
+    std::array<float, 16> inverse;
+    for (std::size_t i = 0; i < inverse.size(); ++i) {
+        inverse[i] = linearInverse[i];
+    }
+    for (std::size_t row = 0; row < 3; ++row) {
+        inverse[row*4 + 3] = -(linearInverse[row*4] * this->translation.x()
+                               + linearInverse[row*4 + 1] * this->translation.y()
+                               + linearInverse[row*4 + 2] * this->translation.z());
+    }
+    return Matrix4(inverse);
+}
+
+void OpenGlMatrix::updateInverse(void)
+{
+    if (this->inverseValid)
+        return;
+    this->inverseMat = getInverseMatrix();
+    // The normal matrix is the inverse transpose, and the inverse is already known.
+    this->normalMat = Matrix3::transpose(Matrix3(this->inverseMat));
+    this->inverseValid = true;
 }
 
 OpenGlMatrix::OpenGlMatrix()
 {
     this->translation = Vector3();
-    this->rotation = Vector3();
-    this->lateRotation = Vector3();
+    this->rotation = Quaternion();
+    this->lateRotation = Quaternion();
     this->scaling = Vector3(1, 1, 1);
+    this->linearMat = Matrix4();
     this->mat = Matrix4();
+    this->columnMajorMat = ColumnMajorMatrix4();
+    this->inverseMat = Matrix4();
+    this->normalMat = Matrix3();
+    this->dirtyComponents = 0;
+    this->inverseValid = true;
 }
 
 OpenGlMatrix& OpenGlMatrix::addTranslate(const float x, const float y, const float z)
 {
     this->translation += Vector3(x,y,z);
+    markDirty(translationComponent);
     return *this;
 }
 
 OpenGlMatrix& OpenGlMatrix::addRotate(const float x, const float y, const float z)
 {
-    this->rotation += Vector3(x,y,z);
-    return *this;
+    return addRotate(toRotation(x, y, z));
 }
 
 OpenGlMatrix& OpenGlMatrix::addLateRotate(const float x, const float y, const float z)
 {
-    this->lateRotation += Vector3(x,y,z);
+    return addLateRotate(toRotation(x, y, z));
+}
+
+OpenGlMatrix& OpenGlMatrix::addRotate(const Quaternion &rot)
+{
+    // Renormalize, so accumulating many small rotations does not slowly introduce scaling.
+    this->rotation = Quaternion::normalize(rot * this->rotation);
+    markDirty(rotationComponent);
+    return *this;
+}
+
+OpenGlMatrix& OpenGlMatrix::addLateRotate(const Quaternion &rot)
+{
+    this->lateRotation = Quaternion::normalize(rot * this->lateRotation);
+    markDirty(lateRotationComponent);
     return *this;
 }
 
 OpenGlMatrix& OpenGlMatrix::addScale(const float x, const float y, const float z)
 {
     this->scaling += Vector3(x,y,z);
+    markDirty(scalingComponent);
     return *this;
 }
 
 OpenGlMatrix& OpenGlMatrix::setTranslate(const float x, const float y, const float z)
 {
     this->translation = Vector3(x,y,z);
+    markDirty(translationComponent);
     return *this;
 }
 
 OpenGlMatrix& OpenGlMatrix::setRotate(const float x, const float y, const float z)
 {
-    this->rotation = Vector3(x,y,z);
+    this->rotation = toRotation(x, y, z);
+    markDirty(rotationComponent);
     return *this;
 }
 
 OpenGlMatrix& OpenGlMatrix::setLateRotate(const float x, const float y, const float z)
 {
-    this->lateRotation = Vector3(x,y,z);
+    this->lateRotation = toRotation(x, y, z);
+    markDirty(lateRotationComponent);
+    return *this;
+}
+
+OpenGlMatrix& OpenGlMatrix::setRotate(const Quaternion &rot)
+{
+    this->rotation = rot;
+    markDirty(rotationComponent);
+    return *this;
+}
+
+OpenGlMatrix& OpenGlMatrix::setLateRotate(const Quaternion &rot)
+{
+    this->lateRotation = rot;
+    markDirty(lateRotationComponent);
     return *this;
 }
 
 OpenGlMatrix& OpenGlMatrix::setScale(const float x, const float y, const float z)
 {
     this->scaling = Vector3(x,y,z);
+    markDirty(scalingComponent);
     return *this;
 }
 
+void OpenGlMatrix::update(void) noexcept
+{
+    if (this->dirtyComponents != 0) {
+        this->mat = getCombinedMatrix();
+        this->columnMajorMat = ColumnMajorMatrix4(this->mat);
+        this->dirtyComponents = 0;
+    }
+}
+
 const float* OpenGlMatrix::data() noexcept
 {
-   this->mat = getCombinedMatrix();
-   return this->mat.data();
+    update();
+    return this->mat.data();
+}
+
+const float* OpenGlMatrix::columnMajorData() noexcept
+{
+    update();
+    return this->columnMajorMat.data();
+}
+
+const float* OpenGlMatrix::inverseData(void)
+{
+    updateInverse();
+    return this->inverseMat.data();
+}
+
+const float* OpenGlMatrix::normalMatrixData(void)
+{
+    updateInverse();
+    return this->normalMat.data();
+}
+
+std::uint64_t OpenGlMatrix::getVersion(void) const noexcept
+{
+    return this->version.get();
 }
@@ -18,49 +18,49 @@ OrthographicProjectionMatrix::OrthographicProjectionMatrix(const float left, con
     this->up = up;
     this->near = near;
     this->far = far;
-    this->mat = createMatrix();
+    setMatrix(createMatrix());
 }
 
 void OrthographicProjectionMatrix::setLeft(const float left)
 {
     this->left = left;
-    this->mat = createMatrix();
+    setMatrix(createMatrix());
 }
 
 void OrthographicProjectionMatrix::setRight(const float right)
 {
     this->right = right;
-    this->mat = createMatrix();
+    setMatrix(createMatrix());
 }
 
 void OrthographicProjectionMatrix::setBottom(const float bottom)
 {
     this->bottom = bottom;
-    this->mat = createMatrix();
+    setMatrix(createMatrix());
 }
 
 void OrthographicProjectionMatrix::setUp(const float up)
 {
     this->up = up;
-    this->mat = createMatrix();
+    setMatrix(createMatrix());
 }
 
 void OrthographicProjectionMatrix::setNear(const float near)
 {
     this->near = near;
-    this->mat = createMatrix();
+    setMatrix(createMatrix());
 }
 
 void OrthographicProjectionMatrix::setFar(const float far)
 {
     this->far = far;
-    this->mat = createMatrix();
+    setMatrix(createMatrix());
 }
 
 void OrthographicProjectionMatrix::setWindowSize(const float width, const float height)
 {
     this->right = width;
     this->up = height;
-    this->mat = createMatrix();
+    setMatrix(createMatrix());
 }
 
@@ -1,14 +1,17 @@
 #include <cmath>
 
 #include "perspectiveProjectionMatrix.hpp"
+#include "trig.hpp"
 
 
 Matrix4 PerspectiveProjectionMatrix::createMatrix(void)
 {
-
+    // 1/tan(fov/2), computed as cos/sin.
+    const Trig::SinCos halfFov = Trig::sinCos(this->fov/2);
+    const float cotHalfFov = halfFov.cos / halfFov.sin;
     return Matrix4({
-        1/(this->ar*std::tan(this->fov/2))    , 0.0                          , 0.0                                                       , 0.0,
-        0.0                                   , 1/(std::tan(this->fov/2))    , 0.0                                                       , 0.0,
+        cotHalfFov/this->ar                   , 0.0                          , 0.0                                                       , 0.0,
+        0.0                                   , cotHalfFov                   , 0.0                                                       , 0.0,
         0.0                                   , 0.0                          , -1*((this->near + this->far) / (this->far - this->near))  , (-2*this->far*this->near)/(this->far - this->near),
         0.0                                   , 0.0                          , -1.0                                                      , 0.0
     });
@@ -20,31 +23,31 @@ PerspectiveProjectionMatrix::PerspectiveProjectionMatrix(const float fov, const
    this->ar = width/height;
    this->near = near;
    this->far = far;
-   this->mat = this->createMatrix();
+   setMatrix(this->createMatrix());
 }
 
 void PerspectiveProjectionMatrix::setFov(const float fov)
 {
     this->fov = fov;
-    this->mat = this->createMatrix();
+    setMatrix(this->createMatrix());
 }
 
 void PerspectiveProjectionMatrix::setNear(const float near)
 {
     this->near = near;
-    this->mat = this->createMatrix();
+    setMatrix(this->createMatrix());
 }
 
 void PerspectiveProjectionMatrix::setFar(const float far)
 {
     this->far = far;
-    this->mat = this->createMatrix();
+    setMatrix(this->createMatrix());
 }
 
 void PerspectiveProjectionMatrix::setWindowSize(float width, float height)
 {
     this->ar = width/height;
-    this->mat = this->createMatrix();
+    setMatrix(this->createMatrix());
 }
 
 void PerspectiveProjectionMatrix::setScrollOffset(const double xoffset, const double yoffset)
@@ -54,5 +57,5 @@ void PerspectiveProjectionMatrix::setScrollOffset(const double xoffset, const do
         fov = 0.01;
     else if (fov > M_PI/4)
         fov = M_PI/4;
-    this->mat = this->createMatrix();
+    setMatrix(this->createMatrix());
 }
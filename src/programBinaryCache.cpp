@@ -0,0 +1,161 @@
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+
+#include "programBinaryCache.hpp"
+#include "fnv1a.hpp"
+// glad has to be included before GLFW.
+#include <GLFW/glfw3.h>
+
+namespace {
+    /**The start of every cache file.*/
+    struct FileHeader {
+        char magic[8];
+        std::uint64_t key;
+        std::uint32_t format;
+        std::uint32_t length;
+    };
+    constexpr char fileMagic[8] = {'G', 'L', 'P', 'R', 'O', 'G', 'B', '1'};
+
+    std::string_view getString(const GLenum name)
+    {
+        const GLubyte *str = glGetString(name);
+        return str == nullptr ? std::string_view() : std::string_view(reinterpret_cast<const char*>(str));
+    }
+}
+
+ProgramBinaryCache::ProgramBinaryCache(const std::filesystem::path &directory) :
+    directory(directory),
+    getProgramBinary(reinterpret_cast<GetProgramBinaryFunction>(glfwGetProcAddress("glGetProgramBinary"))),
+    programBinary(reinterpret_cast<ProgramBinaryFunction>(glfwGetProcAddress("glProgramBinary"))),
+    programParameteri(reinterpret_cast<ProgramParameteriFunction>(glfwGetProcAddress("glProgramParameteri"))),
+    driverHash(Fnv1a::offsetBasis)
+{
+    GLint formats = 0;
+    if (getProgramBinary != nullptr && programBinary != nullptr && programParameteri != nullptr)
+        glGetIntegerv(numProgramBinaryFormats, &formats);
+    if (formats <= 0) {
+        // Also swallows the GL_INVALID_ENUM of a driver which does not know numProgramBinaryFormats.
+        glGetError();
+        this->getProgramBinary = nullptr;
+        return;
+    }
+    for (const GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        // The terminating 0 separates the strings, so moving text from one to the next changes the hash.
+        this->driverHash = Fnv1a::hash(getString(name), this->driverHash);
+        this->driverHash = Fnv1a::hash(std::string_view("", 1), this->driverHash);
+    }
+    std::error_code err;
+    std::filesystem::create_directories(this->directory, err);
+}
+
+std::filesystem::path ProgramBinaryCache::getPath(const std::uint64_t key) const
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return this->directory / name.str();
+}
+
+bool ProgramBinaryCache::isAvailable(void) const noexcept
+{
+    return this->getProgramBinary != nullptr;
+}
+
+std::uint64_t ProgramBinaryCache::getKey(const std::initializer_list<std::string_view> sources) const noexcept
+{
+    std::uint64_t key = this->driverHash;
+    for (const std::string_view source : sources) {
+        key = Fnv1a::hash(source, key);
+        key = Fnv1a::hash(std::string_view("", 1), key);
+    }
+    return key;
+}
+
+void ProgramBinaryCache::prepareForStore(const GLuint program) const
+{
+    if (isAvailable())
+        this->programParameteri(program, programBinaryRetrievableHint, GL_TRUE);
+}
+
+GLuint ProgramBinaryCache::load(const std::uint64_t key) const
+{
+    if (!isAvailable())
+        return 0;
+    const std::filesystem::path path = getPath(key);
+    std::ifstream file(path, std::ios::binary);
+    FileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return 0;
+    std::vector<char> binary;
+    bool valid = std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) == 0 && header.key == key;
+    // The length is only trusted if the file really holds that much, a corrupt one could ask for gigabytes.
+    std::error_code sizeErr;
+    const std::uintmax_t fileSize = std::filesystem::file_size(path, sizeErr);
+    valid = valid && !sizeErr && fileSize - sizeof(header) == header.length;
+    if (valid) {
+        binary.resize(header.length);
+        valid = static_cast<bool>(file.read(binary.data(), header.length));
+    }
+    file.close();
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        this->programBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint success = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (success == GL_FALSE) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    if (program == 0) {
+        // An error of glProgramBinary is expected here, it should not be reported by the next check of the caller.
+        glGetError();
+        std::error_code err;
+        std::filesystem::remove(path, err);
+    }
+    return program;
+}
+
+void ProgramBinaryCache::store(const GLuint program, const std::uint64_t key) const
+{
+    if (!isAvailable())
+        return;
+    GLint length = 0;
+    glGetProgramiv(program, programBinaryLength, &length);
+    if (length <= 0)
+        return;
+    std::vector<char> binary(static_cast<std::size_t>(length));
+    FileHeader header;
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.key = key;
+    GLsizei written = 0;
+    GLenum format = 0;
+    this->getProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+    header.format = format;
+    header.length = static_cast<std::uint32_t>(written);
+
+    // Write to a temporary file first, so another instance never reads a half written binary. Its name is unique to
+    // this process and this call, so two instances storing the same program never write into the same file.
+    static std::atomic<std::uint64_t> temporaryCount{0};
+    const std::filesystem::path path = getPath(key);
+    std::filesystem::path temporaryPath = path;
+    temporaryPath += "." + std::to_string(getpid()) + "." + std::to_string(temporaryCount++) + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), written);
+    file.close();
+    std::error_code err;
+    if (file) {
+        std::filesystem::rename(temporaryPath, path, err);
+    } else {
+        std::filesystem::remove(temporaryPath, err);
+    }
+}
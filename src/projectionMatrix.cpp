@@ -45,7 +45,23 @@ void ProjectionMatrix::unregister(void)
     }
 }
 
+void ProjectionMatrix::setMatrix(const Matrix4 &matrix)
+{
+    this->mat = matrix;
+    this->columnMajorMat = ColumnMajorMatrix4(matrix);
+}
+
 const float* ProjectionMatrix::data(void) const noexcept
 {
     return this->mat.data();
 }
+
+const float* ProjectionMatrix::columnMajorData(void) const noexcept
+{
+    return this->columnMajorMat.data();
+}
+
+const Matrix4& ProjectionMatrix::getMatrix(void) const noexcept
+{
+    return this->mat;
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+
+#include "quaternion.hpp"
+#include "trig.hpp"
+
+Quaternion::Quaternion(const float w, const float x, const float y, const float z) : qw(w), qx(x), qy(y), qz(z)
+{}
+
+Quaternion Quaternion::fromAxisAngle(const Vector3 &axis, const float angle)
+{
+    const Vector3 unitAxis = Vector3::normalize(axis);
+    const Trig::SinCos half = Trig::sinCos(angle / 2);
+    return Quaternion(half.cos, unitAxis.x() * half.sin, unitAxis.y() * half.sin, unitAxis.z() * half.sin);
+}
+
+Quaternion Quaternion::fromHalfAngles(const float cx, const float sx, const float cy, const float sy, const float cz,
+                                      const float sz)
+{
+    // This is fromAxisAngle(z-axis, z) * fromAxisAngle(y-axis, y) * fromAxisAngle(x-axis, x), written out.
+    return Quaternion(
+            cx * cy * cz + sx * sy * sz,
+            sx * cy * cz - cx * sy * sz,
+            cx * sy * cz + sx * cy * sz,
+            cx * cy * sz - sx * sy * cz);
+}
+
+Quaternion Quaternion::fromEulerAngles(const float x, const float y, const float z)
+{
+    const Trig::SinCos halfX = Trig::sinCos(x / 2);
+    const Trig::SinCos halfY = Trig::sinCos(y / 2);
+    const Trig::SinCos halfZ = Trig::sinCos(z / 2);
+    return fromHalfAngles(halfX.cos, halfX.sin, halfY.cos, halfY.sin, halfZ.cos, halfZ.sin);
+}
+
+void Quaternion::fromEulerAngles(const float* x, const float* y, const float* z, Quaternion* out,
+                                 const std::size_t count)
+{
+    // Process the angles in chunks, so the sines and cosines of a chunk are computed in three batches.
+    constexpr std::size_t chunkSize = 64;
+    float halfAngles[3][chunkSize];
+    float sines[3][chunkSize];
+    float cosines[3][chunkSize];
+    for (std::size_t start = 0; start < count; start += chunkSize) {
+        const std::size_t size = std::min(chunkSize, count - start);
+        for (std::size_t i = 0; i < size; ++i) {
+            halfAngles[0][i] = x[start + i] / 2;
+            halfAngles[1][i] = y[start + i] / 2;
+            halfAngles[2][i] = z[start + i] / 2;
+        }
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            Trig::sinCos(halfAngles[axis], sines[axis], cosines[axis], size);
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            out[start + i] = fromHalfAngles(cosines[0][i], sines[0][i], cosines[1][i], sines[1][i], cosines[2][i],
+                                            sines[2][i]);
+        }
+    }
+}
+
+Quaternion Quaternion::slerp(const Quaternion &from, const Quaternion &to, const float t)
+{
+    float cosTheta = dot(from, to);
+    // q and -q represent the same rotation. Pick the one which gives the shortest path.
+    const float sign = cosTheta < 0 ? -1.0f : 1.0f;
+    cosTheta *= sign;
+    float fromWeight = 1 - t;
+    float toWeight = t;
+    // For (almost) equal rotations sin(theta) approaches zero, but then linear interpolation is accurate enough.
+    if (cosTheta < 0.9995f) {
+        const float theta = std::acos(cosTheta);
+        const float sinTheta = std::sin(theta);
+        fromWeight = std::sin(fromWeight * theta) / sinTheta;
+        toWeight = std::sin(toWeight * theta) / sinTheta;
+    }
+    toWeight *= sign;
+    return normalize(Quaternion(
+            fromWeight * from.qw + toWeight * to.qw,
+            fromWeight * from.qx + toWeight * to.qx,
+            fromWeight * from.qy + toWeight * to.qy,
+            fromWeight * from.qz + toWeight * to.qz));
+}
+
+void Quaternion::slerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out,
+                       const std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = slerp(from[i], to[i], t[i]);
+    }
+}
+
+void Quaternion::slerp(const Quaternion* from, const Quaternion* to, const float t, Quaternion* out,
+                       const std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = slerp(from[i], to[i], t);
+    }
+}
+
+Quaternion Quaternion::normalize(Quaternion quat)
+{
+    const float norm = std::sqrt(dot(quat, quat));
+    quat.qw /= norm;
+    quat.qx /= norm;
+    quat.qy /= norm;
+    quat.qz /= norm;
+    return quat;
+}
+
+Quaternion Quaternion::conjugate(const Quaternion &quat)
+{
+    return Quaternion(quat.qw, -quat.qx, -quat.qy, -quat.qz);
+}
+
+float Quaternion::dot(const Quaternion &lhs, const Quaternion &rhs)
+{
+    return lhs.qw * rhs.qw + lhs.qx * rhs.qx + lhs.qy * rhs.qy + lhs.qz * rhs.qz;
+}
+
+Matrix4 Quaternion::toMatrix4(void) const
+{
+    const float xx = qx * qx;
+    const float yy = qy * qy;
+    const float zz = qz * qz;
+    const float xy = qx * qy;
+    const float xz = qx * qz;
+    const float yz = qy * qz;
+    const float wx = qw * qx;
+    const float wy = qw * qy;
+    const float wz = qw * qz;
+    return Matrix4({
+        1 - 2 * (yy + zz),  2 * (xy - wz),      2 * (xz + wy),      0,
+        2 * (xy + wz),      1 - 2 * (xx + zz),  2 * (yz - wx),      0,
+        2 * (xz - wy),      2 * (yz + wx),      1 - 2 * (xx + yy),  0,
+        0,                  0,                  0,                  1,
+    });
+}
+
+Vector3 Quaternion::rotate(const Vector3 &vec) const
+{
+    // v' = v + 2w(u x v) + 2(u x (u x v)), where u is the vector part. This is q * v * conjugate(q), written out.
+    const Vector3 u(qx, qy, qz);
+    const Vector3 uv = Vector3::crossProduct(u, vec);
+    const Vector3 uuv = Vector3::crossProduct(u, uv);
+    return vec + 2 * qw * uv + 2 * uuv;
+}
+
+float Quaternion::w() const
+{
+    return qw;
+}
+
+float Quaternion::x() const
+{
+    return qx;
+}
+
+float Quaternion::y() const
+{
+    return qy;
+}
+
+float Quaternion::z() const
+{
+    return qz;
+}
+
+Quaternion& Quaternion::operator*=(const Quaternion &other)
+{
+    const float w = qw * other.qw - qx * other.qx - qy * other.qy - qz * other.qz;
+    const float x = qw * other.qx + qx * other.qw + qy * other.qz - qz * other.qy;
+    const float y = qw * other.qy - qx * other.qz + qy * other.qw + qz * other.qx;
+    const float z = qw * other.qz + qx * other.qy - qy * other.qx + qz * other.qw;
+    qw = w;
+    qx = x;
+    qy = y;
+    qz = z;
+    return *this;
+}
+
+Quaternion operator*(Quaternion lhs, const Quaternion &rhs)
+{
+    lhs *= rhs;
+    return lhs;
+}
@@ -4,8 +4,12 @@
 #include <utility>
 #include <cerrno>
 #include <cstring>
+#include <algorithm>
+#include <filesystem>
 
 #include "shaderProgram.hpp"
+#include "cameraUniformBuffer.hpp"
+#include "embeddedResources.hpp"
 #include "glErrorToString.hpp"
 
 std::string ShaderProgram::getCompilationError(GLuint shader)
@@ -32,119 +36,215 @@ std::string ShaderProgram::getLinkingError(GLuint shaderProgram)
     return linkerOutput;
 }
 
-GLint ShaderProgram::getUniformLocation(const std::string &name) const
+const UniformTable::Uniform& ShaderProgram::findUniform(const std::string_view name) const
 {
-   GLint location = glGetUniformLocation(this->shaderProgram, name.c_str());
-   if (location == -1) {
+    const UniformTable::Uniform *uniform = this->uniforms.find(name);
+    if (uniform == nullptr) {
         std::ostringstream errStream;
-        errStream << "Retrieving uniform location for uniform with name " << name << " failed: " << glErrorToString(glGetError());
+        errStream << "The shader program has no active uniform with name " << name;
         throw std::runtime_error(errStream.str());
-   }
-   return location;
+    }
+    return *uniform;
 }
 
-ShaderProgram::ShaderProgram(const std::string &vertexShaderPath, const std::string &fragmentShaderPath)
+void ShaderProgram::throwTypeMismatch(const UniformTable::Uniform &uniform) const
 {
-    // Load and compile vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    if (vertexShader == 0) {
-        std::ostringstream errStream;
-        errStream << "Creating vertex shader failed: " << glErrorToString(glGetError());
-        throw std::runtime_error(errStream.str());
-    }
+    std::ostringstream errStream;
+    errStream << "Uniform " << uniform.name << " has GL type 0x" << std::hex << uniform.type
+              << ", which does not match the type of the handle";
+    throw std::runtime_error(errStream.str());
+}
+
+std::string ShaderProgram::readSource(const std::string &path)
+{
+    if (const EmbeddedResources::Resource *resource = EmbeddedResources::find(path))
+        return std::string(resource->data);
     try {
-        std::ifstream vertexShaderFile(vertexShaderPath.c_str());
-        vertexShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        std::stringstream vertexShaderContents;
-        vertexShaderContents << vertexShaderFile.rdbuf();
-        std::string const &vertexCodeString = vertexShaderContents.str();
-        char const *code = vertexCodeString.c_str();
-        glShaderSource(vertexShader, 1, &code, nullptr);
+        std::ifstream file(path.c_str());
+        file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
     } catch (const std::ios_base::failure &e) {
-        glDeleteShader(vertexShader);
         // The usage of errno requires POSIX.
         // This trick also has no guarantee of working. It does work, though.
         std::ostringstream errStream;
-        errStream << "Failure reading from " << vertexShaderPath << ". Errno: " << errno << " (" << strerror(errno) << ")" << std::endl;
+        errStream << "Failure reading from " << path << ". Errno: " << errno << " (" << strerror(errno) << ")";
         throw std::runtime_error(errStream.str());
     }
-    GLint success;
-    glCompileShader(vertexShader);
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (success == GL_FALSE) {
-        std::string error = getCompilationError(vertexShader);
-        glDeleteShader(vertexShader);
-        std::stringstream errStream;
-        errStream << "Compiling vertex shader " << vertexShaderPath << " failed: " << error;
+}
+
+void ShaderProgram::appendSource(const std::string &path, Source &source, const Defines *defines)
+{
+    const std::string fileIndex = std::to_string(source.files.size());
+    source.files.push_back(path);
+    std::istringstream contents(readSource(path));
+    const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    if (defines == nullptr)
+        source.code += "#line 1 " + fileIndex + "\n";
+    bool definesInserted = defines == nullptr || defines->empty();
+    std::string line;
+    for (std::size_t lineNumber = 1; std::getline(contents, line); ++lineNumber) {
+        const std::size_t start = std::min(line.find_first_not_of(" \t"), line.size());
+        const std::string_view directive = std::string_view(line).substr(start);
+        if (!definesInserted && directive.starts_with("#version")) {
+            source.code += line + "\n";
+            for (const Define &define : *defines) {
+                source.code += "#define " + define.name + " " + define.value + "\n";
+            }
+            source.code += "#line " + std::to_string(lineNumber + 1) + " " + fileIndex + "\n";
+            definesInserted = true;
+        } else if (directive.starts_with("#include")) {
+            const std::size_t open = directive.find('"');
+            const std::size_t close = open == std::string_view::npos ? open : directive.find('"', open + 1);
+            if (close == std::string_view::npos) {
+                std::ostringstream errStream;
+                errStream << path << ":" << lineNumber << ": Malformed #include, expected #include \"file\"";
+                throw std::runtime_error(errStream.str());
+            }
+            const std::string includePath =
+                (directory / directive.substr(open + 1, close - open - 1)).lexically_normal().string();
+            if (std::find(source.files.begin(), source.files.end(), includePath) == source.files.end())
+                appendSource(includePath, source, nullptr);
+            source.code += "#line " + std::to_string(lineNumber + 1) + " " + fileIndex + "\n";
+        } else {
+            source.code += line + "\n";
+        }
+    }
+    if (!definesInserted) {
+        std::ostringstream errStream;
+        errStream << path << ": Defines can only be inserted into a shader with a #version line";
         throw std::runtime_error(errStream.str());
     }
+}
 
-    // Load and compile fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    if (fragmentShader == 0) {
-        std::stringstream errStream;
-        errStream << "Creating fragment shader failed: " << glErrorToString(glGetError());
-        throw std::runtime_error(errStream.str());
+ShaderProgram::Source ShaderProgram::preprocess(const std::string &path, const Defines &defines)
+{
+    Source source;
+    appendSource(std::filesystem::path(path).lexically_normal().string(), source, &defines);
+    return source;
+}
+
+std::string ShaderProgram::describeCompilationError(const GLenum type, const GLuint shader,
+                                                    const std::vector<std::string> &files)
+{
+    std::ostringstream errStream;
+    errStream << "Compiling " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader " << files[0]
+              << " failed: " << getCompilationError(shader);
+    if (files.size() > 1) {
+        errStream << "Source string numbers:";
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            errStream << " " << i << " = " << files[i];
+        }
     }
-    try {
-        std::ifstream fragmentShaderFile(fragmentShaderPath.c_str());
-        fragmentShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        std::stringstream fragmentShaderContents;
-        fragmentShaderContents << fragmentShaderFile.rdbuf();
-        std::string const &fragmentCodeString = fragmentShaderContents.str();
-        char const *code = fragmentCodeString.c_str();
-        glShaderSource(fragmentShader, 1, &code, nullptr);
-    } catch (const std::ios_base::failure &e) {
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        // The usage of errno requires POSIX.
+    return errStream.str();
+}
+
+GLuint ShaderProgram::compileShader(const GLenum type, const Source &source)
+{
+    GLuint shader = glCreateShader(type);
+    if (shader == 0) {
         std::ostringstream errStream;
-        errStream << "Failure reading from " << fragmentShaderPath << ". Errno: " << errno << " (" << strerror(errno) << ")";
+        errStream << "Creating " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader failed: "
+                  << glErrorToString(glGetError());
         throw std::runtime_error(errStream.str());
     }
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+    char const *code = source.code.c_str();
+    glShaderSource(shader, 1, &code, nullptr);
+    GLint success;
+    glCompileShader(shader);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (success == GL_FALSE) {
-        std::string error = getCompilationError(fragmentShader);
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        std::ostringstream errStream;
-        errStream << "Compiling fragment shader " << fragmentShaderPath << " failed: " << error;
-        throw std::runtime_error(errStream.str());
+        std::string error = describeCompilationError(type, shader, source.files);
+        glDeleteShader(shader);
+        throw std::runtime_error(error);
     }
+    return shader;
+}
 
-    // Link the two together
-    GLuint &shaderProgram = this->shaderProgram;
-    shaderProgram = glCreateProgram();
+GLuint ShaderProgram::linkProgram(const GLuint vertexShader, const GLuint fragmentShader,
+                                  const ProgramBinaryCache *binaryCache)
+{
+    GLuint shaderProgram = glCreateProgram();
     if (shaderProgram == 0) {
         std::stringstream errStream;
         errStream << "Creating shader program failed: " << glErrorToString(glGetError());
         throw std::runtime_error(errStream.str());
     }
+    if (binaryCache != nullptr)
+        binaryCache->prepareForStore(shaderProgram);
     glAttachShader(shaderProgram, vertexShader);
     glAttachShader(shaderProgram, fragmentShader);
     glLinkProgram(shaderProgram);
-    // We no longer need the shaders.
+    // The program no longer needs the shaders.
     glDetachShader(shaderProgram, vertexShader);
-    glDeleteShader(vertexShader);
     glDetachShader(shaderProgram, fragmentShader);
-    glDeleteShader(fragmentShader);
 
+    GLint success;
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
     if (success == GL_FALSE) {
         std::string error = getLinkingError(shaderProgram);
         glDeleteProgram(shaderProgram);
         throw std::runtime_error("Shader linking stage failed: " + error);
     }
+    return shaderProgram;
+}
+
+void ShaderProgram::initialize(void)
+{
+    // This is not part of the program binary, so it is also needed for a cached program.
+    // Programs which use the camera data read it from the CameraUniformBuffer.
+    const GLuint cameraBlock = glGetUniformBlockIndex(this->shaderProgram, CameraUniformBuffer::blockName);
+    if (cameraBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(this->shaderProgram, cameraBlock, CameraUniformBuffer::bindingPoint);
+
+    this->uniforms = UniformTable(this->shaderProgram);
+}
+
+ShaderProgram::ShaderProgram(const GLuint linkedProgram) : shaderProgram(linkedProgram)
+{
+    initialize();
+}
+
+ShaderProgram::ShaderProgram(const std::string &vertexShaderPath, const std::string &fragmentShaderPath,
+                             const ProgramBinaryCache *binaryCache, const Defines &defines) : shaderProgram(0)
+{
+    const Source vertexSource = preprocess(vertexShaderPath, defines);
+    const Source fragmentSource = preprocess(fragmentShaderPath, defines);
+
+    std::uint64_t cacheKey = 0;
+    if (binaryCache != nullptr) {
+        cacheKey = binaryCache->getKey({vertexSource.code, fragmentSource.code});
+        this->shaderProgram = binaryCache->load(cacheKey);
+    }
+    if (this->shaderProgram == 0) {
+        GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+        GLuint fragmentShader = 0;
+        try {
+            fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+            this->shaderProgram = linkProgram(vertexShader, fragmentShader, binaryCache);
+        } catch (...) {
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+            throw;
+        }
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        if (binaryCache != nullptr)
+            binaryCache->store(this->shaderProgram, cacheKey);
+    }
+    initialize();
 }
 
-ShaderProgram::ShaderProgram(ShaderProgram&& other) : shaderProgram(std::exchange(other.shaderProgram, 0))
+ShaderProgram::ShaderProgram(ShaderProgram&& other) :
+    shaderProgram(std::exchange(other.shaderProgram, 0)), uniforms(std::move(other.uniforms))
 {}
 
 
 ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other)
 {
     this->shaderProgram = std::exchange(other.shaderProgram, 0);
+    this->uniforms = std::move(other.uniforms);
     return *this;
 }
 
@@ -159,22 +259,32 @@ void ShaderProgram::use() const
     glUseProgram(this->shaderProgram);
 }
 
-void ShaderProgram::setUniformMatrix4v(const std::string &name, const size_t count, const bool transpose, const float* value) const
+bool ShaderProgram::hasUniform(const std::string_view name) const noexcept
+{
+    return this->uniforms.find(name) != nullptr;
+}
+
+void ShaderProgram::setUniformMatrix4v(const std::string_view name, const size_t count, const bool transpose, const float* value) const
+{
+    glUniformMatrix4fv(findUniform(name).location, count, transpose, value);
+}
+
+void ShaderProgram::setUniformMatrix3v(const std::string_view name, const size_t count, const bool transpose, const float* value) const
 {
-    glUniformMatrix4fv(getUniformLocation(name), count, transpose, value);
+    glUniformMatrix3fv(findUniform(name).location, count, transpose, value);
 }
 
-void ShaderProgram::setUniform3f(const std::string &name, const float v0, const float v1, const float v2) const
+void ShaderProgram::setUniform3f(const std::string_view name, const float v0, const float v1, const float v2) const
 {
-    glUniform3f(getUniformLocation(name), v0, v1, v2);
+    glUniform3f(findUniform(name).location, v0, v1, v2);
 }
 
-void ShaderProgram::setUniform3f(const std::string &name, const Vector4 &vec) const
+void ShaderProgram::setUniform3f(const std::string_view name, const Vector3 &vec) const
 {
-    glUniform3f(getUniformLocation(name), vec[0], vec[1], vec[2]);
+    glUniform3f(findUniform(name).location, vec[0], vec[1], vec[2]);
 }
 
-void ShaderProgram::setUniform1i(const std::string &name, const GLint v0) const
+void ShaderProgram::setUniform1i(const std::string_view name, const GLint v0) const
 {
-    glUniform1i(getUniformLocation(name), v0);
+    glUniform1i(findUniform(name).location, v0);
 }
@@ -0,0 +1,252 @@
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "shaderRegistry.hpp"
+#include "fnv1a.hpp"
+#include "glErrorToString.hpp"
+// glad has to be included before GLFW.
+#include <GLFW/glfw3.h>
+
+ShaderRegistry::ShaderKey ShaderRegistry::getShaderKey(const GLenum type, const std::string &source) noexcept
+{
+    const char typeName = type == GL_VERTEX_SHADER ? 'v' : 'f';
+    return Fnv1a::hash(source, Fnv1a::hash(std::string_view(&typeName, 1)));
+}
+
+bool ShaderRegistry::hasExtension(const std::string &name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const GLubyte *extension = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+        if (extension != nullptr && name == reinterpret_cast<const char*>(extension))
+            return true;
+    }
+    return false;
+}
+
+GLuint ShaderRegistry::submitShader(const ShaderKey key, const GLenum type, const ShaderProgram::Source &source,
+                                    ProgramStatistics &stats)
+{
+    const auto it = this->shaders.find(key);
+    if (it != this->shaders.end())
+        return it->second.shader;
+    const auto start = std::chrono::steady_clock::now();
+    const GLuint shader = glCreateShader(type);
+    if (shader == 0) {
+        std::ostringstream errStream;
+        errStream << "Creating " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader failed: "
+                  << glErrorToString(glGetError());
+        throw std::runtime_error(errStream.str());
+    }
+    const char *code = source.code.c_str();
+    glShaderSource(shader, 1, &code, nullptr);
+    // The compile status is only queried in checkShader, querying it now would wait for the compilation.
+    glCompileShader(shader);
+    stats.compileTime += std::chrono::steady_clock::now() - start;
+    stats.compiledShaders++;
+    this->shaders.emplace(key, Shader{shader, type, source.files, false, false, {}});
+    return shader;
+}
+
+void ShaderRegistry::checkShader(const ShaderKey key)
+{
+    Shader &shader = this->shaders.at(key);
+    if (shader.failed)
+        throw std::runtime_error(shader.error);
+    if (shader.checked)
+        return;
+    GLint success;
+    glGetShaderiv(shader.shader, GL_COMPILE_STATUS, &success);
+    if (success == GL_FALSE) {
+        // Other programs may use this shader as well, they report the same error.
+        shader.error = ShaderProgram::describeCompilationError(shader.type, shader.shader, shader.files);
+        shader.failed = true;
+        throw std::runtime_error(shader.error);
+    }
+    shader.checked = true;
+}
+
+void ShaderRegistry::finish(PendingProgram &pending)
+{
+    // Whatever happens, the request is no longer pending.
+    this->pendingPrograms.erase(pending.key);
+    try {
+        checkShader(pending.key.first);
+        checkShader(pending.key.second);
+        GLint success;
+        glGetProgramiv(pending.program, GL_LINK_STATUS, &success);
+        if (success == GL_FALSE)
+            throw std::runtime_error("Shader linking stage failed: " + ShaderProgram::getLinkingError(pending.program));
+    } catch (const std::runtime_error &e) {
+        // Getting the program again throws the same error, without touching the deleted program.
+        pending.error = e.what();
+        glDeleteProgram(std::exchange(pending.program, 0));
+        throw;
+    }
+    pending.stats.linkTime = std::chrono::steady_clock::now() - pending.linkStart;
+    if (this->binaryCache != nullptr)
+        this->binaryCache->store(pending.program, pending.cacheKey);
+
+    // The constructor is private, so std::make_shared cannot be used.
+    pending.result = std::shared_ptr<const ShaderProgram>(new ShaderProgram(pending.program));
+    this->programs[pending.key] = pending.result;
+    this->statistics.push_back(pending.stats);
+}
+
+ShaderRegistry::PendingProgram::~PendingProgram(void)
+{
+    if (this->program != 0 && !this->result)
+        glDeleteProgram(this->program);
+}
+
+ShaderRegistry::ProgramRequest::ProgramRequest(std::shared_ptr<PendingProgram> pending) : pending(std::move(pending))
+{}
+
+ShaderRegistry::ShaderRegistry(const ProgramBinaryCache *binaryCache) :
+    binaryCache(binaryCache), parallelCompile(false)
+{
+    if (hasExtension("GL_KHR_parallel_shader_compile")) {
+        const auto maxShaderCompilerThreads = reinterpret_cast<GlMaxShaderCompilerThreadsFunction>(
+            glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+        if (maxShaderCompilerThreads != nullptr) {
+            // Let the driver choose the number of threads.
+            maxShaderCompilerThreads(0xFFFFFFFF);
+            this->parallelCompile = true;
+        }
+    }
+}
+
+ShaderRegistry::~ShaderRegistry(void)
+{
+    for (const auto &[key, pending] : this->pendingPrograms) {
+        if (const std::shared_ptr<PendingProgram> p = pending.lock())
+            glDeleteProgram(std::exchange(p->program, 0));
+    }
+    for (const auto &[key, shader] : this->shaders) {
+        glDeleteShader(shader.shader);
+    }
+}
+
+ShaderRegistry::ProgramRequest ShaderRegistry::requestProgram(const std::string &vertexShaderPath,
+                                                              const std::string &fragmentShaderPath,
+                                                              const ShaderProgram::Defines &defines)
+{
+    const ShaderProgram::Source vertexSource = ShaderProgram::preprocess(vertexShaderPath, defines);
+    const ShaderProgram::Source fragmentSource = ShaderProgram::preprocess(fragmentShaderPath, defines);
+    const ProgramKey key(getShaderKey(GL_VERTEX_SHADER, vertexSource.code),
+                         getShaderKey(GL_FRAGMENT_SHADER, fragmentSource.code));
+
+    std::erase_if(this->pendingPrograms, [](const auto &entry) { return entry.second.expired(); });
+    auto pending = std::make_shared<PendingProgram>();
+    const auto program = this->programs.find(key);
+    if (program != this->programs.end()) {
+        pending->result = program->second.lock();
+        if (pending->result)
+            return ProgramRequest(pending);
+    }
+    const auto other = this->pendingPrograms.find(key);
+    if (other != this->pendingPrograms.end()) {
+        if (std::shared_ptr<PendingProgram> p = other->second.lock())
+            return ProgramRequest(p);
+    }
+
+    pending->key = key;
+    pending->stats = ProgramStatistics{vertexShaderPath, fragmentShaderPath, defines, {}, {}, 0, false};
+    pending->linkStart = std::chrono::steady_clock::now();
+    if (this->binaryCache != nullptr) {
+        pending->cacheKey = this->binaryCache->getKey({vertexSource.code, fragmentSource.code});
+        const GLuint cached = this->binaryCache->load(pending->cacheKey);
+        if (cached != 0) {
+            pending->stats.linkTime = std::chrono::steady_clock::now() - pending->linkStart;
+            pending->stats.loadedFromBinaryCache = true;
+            pending->result = std::shared_ptr<const ShaderProgram>(new ShaderProgram(cached));
+            this->programs[key] = pending->result;
+            this->statistics.push_back(pending->stats);
+            return ProgramRequest(pending);
+        }
+    }
+
+    const GLuint vertexShader = submitShader(key.first, GL_VERTEX_SHADER, vertexSource, pending->stats);
+    const GLuint fragmentShader = submitShader(key.second, GL_FRAGMENT_SHADER, fragmentSource, pending->stats);
+    pending->program = glCreateProgram();
+    if (pending->program == 0) {
+        std::ostringstream errStream;
+        errStream << "Creating shader program failed: " << glErrorToString(glGetError());
+        throw std::runtime_error(errStream.str());
+    }
+    if (this->binaryCache != nullptr)
+        this->binaryCache->prepareForStore(pending->program);
+    pending->linkStart = std::chrono::steady_clock::now();
+    glAttachShader(pending->program, vertexShader);
+    glAttachShader(pending->program, fragmentShader);
+    // Linking uses the shaders as they are now, so they can be detached right away. The link status is only queried
+    // in finish, querying it now would wait for the compilation and the linking.
+    glLinkProgram(pending->program);
+    glDetachShader(pending->program, vertexShader);
+    glDetachShader(pending->program, fragmentShader);
+    this->pendingPrograms[key] = pending;
+    return ProgramRequest(pending);
+}
+
+bool ShaderRegistry::isReady(const ProgramRequest &request) const
+{
+    if (request.pending->result || !request.pending->error.empty() || !this->parallelCompile)
+        return true;
+    GLint done = GL_FALSE;
+    glGetProgramiv(request.pending->program, completionStatus, &done);
+    return done == GL_TRUE;
+}
+
+std::shared_ptr<const ShaderProgram> ShaderRegistry::getProgram(const ProgramRequest &request)
+{
+    if (!request.pending->error.empty())
+        throw std::runtime_error(request.pending->error);
+    if (!request.pending->result)
+        finish(*request.pending);
+    return request.pending->result;
+}
+
+std::shared_ptr<const ShaderProgram> ShaderRegistry::getProgram(const std::string &vertexShaderPath,
+                                                                const std::string &fragmentShaderPath,
+                                                                const ShaderProgram::Defines &defines)
+{
+    return getProgram(requestProgram(vertexShaderPath, fragmentShaderPath, defines));
+}
+
+bool ShaderRegistry::hasParallelCompile(void) const noexcept
+{
+    return this->parallelCompile;
+}
+
+const std::vector<ShaderRegistry::ProgramStatistics>& ShaderRegistry::getStatistics(void) const noexcept
+{
+    return this->statistics;
+}
+
+void ShaderRegistry::writeStatistics(std::ostream &out) const
+{
+    const auto milliseconds = [](const std::chrono::nanoseconds time) -> double {
+        return std::chrono::duration<double, std::milli>(time).count();
+    };
+    out << std::fixed << std::setprecision(3);
+    out << "Parallel shader compilation: " << (this->parallelCompile ? "yes" : "no") << "\n";
+    for (const ProgramStatistics &stats : this->statistics) {
+        out << stats.vertexShaderPath << " + " << stats.fragmentShaderPath;
+        for (const ShaderProgram::Define &define : stats.defines) {
+            out << (&define == &stats.defines.front() ? " [" : " ") << define.name;
+            if (!define.value.empty())
+                out << "=" << define.value;
+        }
+        out << (stats.defines.empty() ? ": " : "]: ");
+        if (stats.loadedFromBinaryCache) {
+            out << "loaded from the binary cache in " << milliseconds(stats.linkTime) << " ms\n";
+        } else {
+            out << "compiled " << stats.compiledShaders << " shader(s) in " << milliseconds(stats.compileTime)
+                << " ms, linked in " << milliseconds(stats.linkTime) << " ms\n";
+        }
+    }
+    out << std::defaultfloat;
+}
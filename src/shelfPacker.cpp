@@ -0,0 +1,43 @@
+#include "shelfPacker.hpp"
+
+ShelfPacker::ShelfPacker(const unsigned width, const unsigned height, const unsigned padding) :
+    width(width), height(height), padding(padding)
+{}
+
+std::optional<ShelfPacker::Rectangle> ShelfPacker::insert(const unsigned rectangleWidth,
+                                                          const unsigned rectangleHeight)
+{
+    // The shelf with the least height to spare that has room for the rectangle.
+    Shelf *best = nullptr;
+    for (Shelf &shelf : this->shelves) {
+        if (shelf.height >= rectangleHeight && shelf.end + rectangleWidth + this->padding <= this->width
+            && (best == nullptr || shelf.height < best->height))
+            best = &shelf;
+    }
+    if (best == nullptr) {
+        const unsigned y = this->shelves.empty() ? this->padding
+                                                 : this->shelves.back().y + this->shelves.back().height + this->padding;
+        if (y + rectangleHeight + this->padding > this->height
+            || this->padding + rectangleWidth + this->padding > this->width)
+            return std::nullopt;
+        best = &this->shelves.emplace_back(Shelf{y, rectangleHeight, this->padding});
+    }
+    const Rectangle rectangle{best->end, best->y, rectangleWidth, rectangleHeight};
+    best->end += rectangleWidth + this->padding;
+    return rectangle;
+}
+
+void ShelfPacker::clear(void) noexcept
+{
+    this->shelves.clear();
+}
+
+unsigned ShelfPacker::getWidth(void) const noexcept
+{
+    return this->width;
+}
+
+unsigned ShelfPacker::getHeight(void) const noexcept
+{
+    return this->height;
+}
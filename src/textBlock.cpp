@@ -0,0 +1,67 @@
+#include "textBlock.hpp"
+
+TextBlock::TextBlock(const TextRenderer &renderer) :
+    renderer(&renderer), glyphCount(0), backgroundVertexCount(0), pages(0), glyphCacheGeneration(0), scale(0),
+    maxLineLenPix(0), vAlign(TextRenderer::VerticalAlignment::top), hAlign(TextRenderer::HorizontalAlignment::left),
+    addBackgroundColor(false), hasText(false)
+{
+    glGenVertexArrays(1, &glyphArray);
+    glGenVertexArrays(1, &backgroundArray);
+    glGenBuffers(1, &glyphBuffer);
+    glGenBuffers(1, &backgroundBuffer);
+    TextRenderer::setUpGlyphArray(glyphArray, glyphBuffer);
+    TextRenderer::setUpBackgroundArray(backgroundArray, backgroundBuffer);
+}
+
+TextBlock::~TextBlock(void)
+{
+    glDeleteVertexArrays(1, &glyphArray);
+    glDeleteVertexArrays(1, &backgroundArray);
+    glDeleteBuffers(1, &glyphBuffer);
+    glDeleteBuffers(1, &backgroundBuffer);
+}
+
+bool TextBlock::setText(const std::string &text, const float scale, const float maxLineLenPix,
+                        const TextRenderer::VerticalAlignment vAlign, const TextRenderer::HorizontalAlignment hAlign,
+                        const Vector3& textColor, const bool addBackgroundColor, const Vector3& backgroundColor)
+{
+    // The background color is a uniform, changing it needs no new layout.
+    this->backgroundColor = backgroundColor;
+    if (this->hasText && text == this->text && scale == this->scale && maxLineLenPix == this->maxLineLenPix
+        && vAlign == this->vAlign && hAlign == this->hAlign && textColor == this->textColor
+        && addBackgroundColor == this->addBackgroundColor)
+        return false;
+
+    this->text = text;
+    this->scale = scale;
+    this->maxLineLenPix = maxLineLenPix;
+    this->vAlign = vAlign;
+    this->hAlign = hAlign;
+    this->textColor = textColor;
+    this->addBackgroundColor = addBackgroundColor;
+    this->hasText = true;
+    layOut();
+    return true;
+}
+
+void TextBlock::layOut(void)
+{
+    TextRenderer::TextLayout layout;
+    this->renderer->layoutText(this->text, this->scale, this->maxLineLenPix, this->vAlign, this->hAlign,
+                               this->textColor, this->addBackgroundColor, layout);
+    this->renderer->upload(this->glyphBuffer, this->backgroundBuffer, layout, GL_STATIC_DRAW);
+    this->glyphCount = layout.glyphs.size();
+    this->backgroundVertexCount = layout.backgroundVertices.size() / 2;
+    this->pages = layout.pages;
+    // Laying out may evict glyphs of other texts, but never the glyphs of this one.
+    this->glyphCacheGeneration = this->renderer->glyphCache.getGeneration();
+}
+
+void TextBlock::draw(const float x, const float y)
+{
+    // Evicted glyphs are rasterized to other places, the uploaded positions may show other glyphs.
+    if (this->hasText && this->glyphCacheGeneration != this->renderer->glyphCache.getGeneration())
+        layOut();
+    this->renderer->draw(this->glyphArray, this->glyphCount, this->backgroundArray, this->backgroundVertexCount,
+                         this->pages, Vector2(x, y), this->scale, this->backgroundColor);
+}
@@ -1,102 +1,191 @@
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <fontconfig/fontconfig.h>
 
 #include "textRenderer.hpp"
 #include "ftErrorToString.hpp"
+#include "embeddedResources.hpp"
+#include "utf8.hpp"
 
-std::vector<std::string> TextRenderer::splitString(const std::string& str, float maxLineLenPix, const float scale) const
+float TextRenderer::getAdvance(const char32_t codePoint) const
 {
-    std::vector<std::string> result;
-    std::stringstream ss(str);
-    for (std::string line; std::getline(ss, line, '\n'); ) {
+    // The advance is in 1/64 pixels.
+    return this->glyphCache.getGlyph(codePoint).advance / 64;
+}
+
+std::vector<LineLayoutCache::Line> TextRenderer::splitString(const std::string_view str, float maxLineLenPix,
+                                                             const float scale) const
+{
+    std::vector<LineLayoutCache::Line> result;
+    const auto addLine = [this, &result, str, scale](const std::size_t begin, const std::size_t length) {
+        result.push_back(LineLayoutCache::Line{begin, length, getLineLengthPixels(str.substr(begin, length), scale)});
+    };
+    // Like std::getline, a newline at the end does not start another line.
+    for (std::size_t lineBegin = 0; lineBegin < str.length(); ) {
+        const std::size_t lineEnd = std::min(str.find('\n', lineBegin), str.length());
+        const std::string_view line = str.substr(lineBegin, lineEnd - lineBegin);
         if (maxLineLenPix == 0) {
-            result.push_back(line);
+            addLine(lineBegin, line.length());
         } else {
-            std::string::size_type lastSplitPos = 0;
-            std::string::size_type lastSpacePos = 0;
+            std::string_view::size_type lastSplitPos = 0;
+            std::string_view::size_type lastSpacePos = 0;
             while (lastSplitPos < line.length()) {
-                std::string::size_type pos = lastSplitPos;
+                std::string_view::size_type pos = lastSplitPos;
+                // The start of the last character counted.
+                std::string_view::size_type characterPos = pos;
                 float pixelCount = 0;
                 while (pos < line.length() && pixelCount < maxLineLenPix) {
                     if (line[pos] == ' ')
                         lastSpacePos = pos;
-                    pixelCount += (this->characters[line[pos]].advance / 64) * scale;
-                    pos++;
+                    characterPos = pos;
+                    pixelCount += getAdvance(Utf8::decode(line, pos)) * scale;
                 }
                 if (pixelCount < maxLineLenPix) {
-                    result.push_back(line.substr(lastSplitPos, pos - lastSplitPos));
+                    addLine(lineBegin + lastSplitPos, pos - lastSplitPos);
                     lastSplitPos = pos;
                 } else {
-                    std::string::size_type endPos = lastSpacePos;
+                    std::string_view::size_type endPos = lastSpacePos;
                     if (endPos == lastSplitPos) {
-                        if (pos != lastSplitPos + 1) {
-                            pos -= 1;
+                        if (characterPos != lastSplitPos) {
+                            pos = characterPos;
                         }
                         endPos = pos;
                     }
-                    std::string s = line.substr(lastSplitPos, endPos - lastSplitPos);
+                    const std::string_view s = line.substr(lastSplitPos, endPos - lastSplitPos);
                     // Now remove trailing and leading spaces
-                    std::size_t begin = s.find_first_not_of(' ');
-                    std::size_t end = s.find_last_not_of(' ');
-                    result.push_back(s.substr(begin, end - begin + 1));
+                    const std::size_t begin = std::min(s.find_first_not_of(' '), s.length());
+                    const std::size_t end = s.find_last_not_of(' ');
+                    addLine(lineBegin + lastSplitPos + begin, end == std::string_view::npos ? 0 : end - begin + 1);
                     lastSplitPos = endPos;
                     lastSpacePos = endPos;
                 }
             }
         }
+        lineBegin = lineEnd + 1;
     }
     return result;
 }
 
-float TextRenderer::getLineLengthPixels(const std::string& line, const float scale) const
+float TextRenderer::getLineLengthPixels(const std::string_view line, const float scale) const
 {
     float len = 0;
-    for (const char& c : line) {
-        len += characters[c].advance;
+    for (std::size_t pos = 0; pos < line.length(); ) {
+        len += getAdvance(Utf8::decode(line, pos));
     }
-    len /= 64;
     return len * scale;
-
 }
 
-void TextRenderer::renderTextLine(const std::string& line, float x, float y, const float scale) const
+void TextRenderer::appendTextLine(const std::string_view line, float x, float y, const float scale,
+                                  const std::array<std::uint8_t, 4> &color, TextLayout &layout) const
 {
-    for (const char& c : line) {
-        std::size_t chIndex = c;
-        if (chIndex > characters.size()){
-            chIndex = '?';
+    for (std::size_t pos = 0; pos < line.length(); ) {
+        const char32_t codePoint = Utf8::decode(line, pos);
+        // Rasterizes the glyph if it is not in the cache, nullptr if there is nothing to draw.
+        const GlyphCache::Glyph *glyph = this->glyphCache.acquire(codePoint);
+        const float advance = getAdvance(codePoint) * scale;
+        if (glyph != nullptr) {
+            const float xpos = x + glyph->left * scale;
+            const float ypos = y - (static_cast<float>(glyph->rows) - glyph->top) * scale;
+            // The vertex shader makes the quad from the position, the size of the glyph in the page and the scale.
+            layout.glyphs.push_back(GlyphInstance{
+                xpos, ypos,
+                glyph->x, static_cast<std::uint16_t>(glyph->y | glyph->page << pageShift),
+                static_cast<std::uint16_t>(glyph->width), static_cast<std::uint16_t>(glyph->rows),
+                color
+            });
+            layout.pages |= std::uint32_t(1) << glyph->page;
         }
-        struct Character ch = characters[chIndex];
-        float xpos = x + ch.bearing.left * scale;
-        float ypos = y - (ch.size.rows - ch.bearing.top) * scale;
+        x += advance;
+    }
+}
+
+void TextRenderer::setUpGlyphArray(const GLuint vertexArray, const GLuint buffer)
+{
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    // Every glyph is one instance, see GlyphInstance and shaders/text.vert. There are no per-vertex attributes.
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+                          reinterpret_cast<void*>(offsetof(GlyphInstance, x)));
+    // The rectangle in the glyph cache in texels, kept as integers for the page in atlasY.
+    glVertexAttribIPointer(1, 4, GL_UNSIGNED_SHORT, sizeof(GlyphInstance),
+                           reinterpret_cast<void*>(offsetof(GlyphInstance, atlasX)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GlyphInstance),
+                          reinterpret_cast<void*>(offsetof(GlyphInstance, color)));
+    for (GLuint attribute = 0; attribute < 3; ++attribute) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    // Unbind them all
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
 
-        float w = ch.size.width * scale;
-        float h = ch.size.rows * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
+void TextRenderer::setUpBackgroundArray(const GLuint vertexArray, const GLuint buffer)
+{
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    // Two triangles per line, with a x,y coordinate per vertex.
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0);
+    glEnableVertexAttribArray(0);
+    // Unbind
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
 
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }
-        };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, textures[chIndex]);
-        // update content of VBO memory
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-        x += (ch.advance / 64) * scale; // bitshift by 6 to get value in pixels (2^6 = 64)
+void TextRenderer::upload(const GLuint glyphBuffer, const GLuint backgroundBuffer, const TextLayout &layout,
+                          const GLenum usage) const
+{
+    // Replacing the whole buffer lets the driver give it new storage, instead of waiting for draws still using it.
+    if (!layout.glyphs.empty()) {
+        glBindBuffer(GL_ARRAY_BUFFER, glyphBuffer);
+        glBufferData(GL_ARRAY_BUFFER, layout.glyphs.size() * sizeof(GlyphInstance), layout.glyphs.data(), usage);
+        this->statistics.bufferUploads++;
     }
+    if (!layout.backgroundVertices.empty()) {
+        glBindBuffer(GL_ARRAY_BUFFER, backgroundBuffer);
+        glBufferData(GL_ARRAY_BUFFER, layout.backgroundVertices.size() * sizeof(float),
+                     layout.backgroundVertices.data(), usage);
+        this->statistics.bufferUploads++;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-TextRenderer::TextRenderer(const std::string &fontHint, const unsigned int pixelWidthHint, const unsigned int pixelHeightHint) :
-    textShader("shaders/text.vert", "shaders/text.frag"),
-    backgroundShader("shaders/textBackground.vert", "shaders/textBackground.frag")
+void TextRenderer::draw(const GLuint glyphArray, const std::size_t glyphCount, const GLuint backgroundArray,
+                        const std::size_t backgroundVertexCount, const std::uint32_t pages, const Vector2 &offset,
+                        const float scale, const Vector3 &backgroundColor) const
+{
+    // Glyphs rasterized by the layouts since the last draw are uploaded together.
+    this->glyphCache.flush();
+    this->glyphCache.touchPages(pages);
+    // The backgrounds go first, the text is drawn over them.
+    if (backgroundVertexCount != 0) {
+        this->backgroundShader->use();
+        this->backgroundColorUniform.set(backgroundColor);
+        this->backgroundOffsetUniform.set(offset);
+        glBindVertexArray(backgroundArray);
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(backgroundVertexCount));
+        this->statistics.drawCalls++;
+    }
+    if (glyphCount != 0) {
+        this->textShader->use();
+        this->scaleUniform.set(scale);
+        this->textOffsetUniform.set(offset);
+        glActiveTexture(GL_TEXTURE0);
+        // Every page of the glyph cache is a layer of one texture array, so this is the only texture bind.
+        glBindTexture(GL_TEXTURE_2D_ARRAY, this->glyphCache.getTexture());
+        glBindVertexArray(glyphArray);
+        // The quad of every glyph is a triangle strip of four vertices.
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(glyphCount));
+        this->statistics.drawCalls++;
+    }
+    this->statistics.glyphs += glyphCount;
+    glBindVertexArray(0);
+}
+
+std::string TextRenderer::findFontFile(const std::string &fontHint)
 {
     FcPattern *pat = FcNameParse((const FcChar8*)fontHint.c_str());
     FcBool success = FcConfigSubstitute(NULL, pat, FcMatchPattern);
@@ -118,13 +207,23 @@ TextRenderer::TextRenderer(const std::string &fontHint, const unsigned int pixel
             fontFileName = std::string(reinterpret_cast<const char*>(file));
         }
     }
-    // Uninitialize fontConfig, then check for succes,
-    // this prevents having to write the same code twice.
+    // Uninitialize fontConfig, the caller checks for success.
     FcPatternDestroy(font);
     FcPatternDestroy(pat);
     FcFini();
 
-    if (fontFileName.size() == 0) {
+    return fontFileName;
+}
+
+GlyphCache::Font TextRenderer::openFont(const std::string &fontHint, const unsigned int pixelWidthHint,
+                                        const unsigned int pixelHeightHint)
+{
+    // The embedded font needs no fontconfig lookup, which reads its configuration and cache from the filesystem.
+    const EmbeddedResources::Resource *embeddedFont = EmbeddedResources::find(EmbeddedResources::fontPath);
+    std::string fontFileName;
+    if (!fontHint.empty() || embeddedFont == nullptr)
+        fontFileName = findFontFile(fontHint);
+    if (fontFileName.size() == 0 && embeddedFont == nullptr) {
         std::ostringstream errStream;
         errStream << "Deriving a font path from font hint " << fontHint << " failed!";
         throw std::runtime_error(errStream.str());
@@ -140,11 +239,17 @@ TextRenderer::TextRenderer(const std::string &fontHint, const unsigned int pixel
     }
     // Load the font face
     FT_Face face;
-    ftErr = FT_New_Face(ft, fontFileName.c_str(), 0, &face);
+    if (fontFileName.size() == 0) {
+        fontFileName = EmbeddedResources::fontPath;
+        ftErr = FT_New_Memory_Face(ft, reinterpret_cast<const FT_Byte*>(embeddedFont->data.data()),
+                                   static_cast<FT_Long>(embeddedFont->data.size()), 0, &face);
+    } else {
+        ftErr = FT_New_Face(ft, fontFileName.c_str(), 0, &face);
+    }
     if (ftErr) {
         FT_Done_FreeType(ft);
         std::ostringstream errStream;
-        errStream << "FT_New_Face failed. Error: " << ftstrerror(ftErr) << " font name: " << fontFileName;
+        errStream << "Loading the font face failed. Error: " << ftstrerror(ftErr) << " font name: " << fontFileName;
         throw std::runtime_error(errStream.str());
     }
     // Set the pixel size
@@ -156,92 +261,44 @@ TextRenderer::TextRenderer(const std::string &fontHint, const unsigned int pixel
         errStream << "FT_Set_Pixel_Sizes failed. Error: " << ftstrerror(ftErr) << " width hint: " << pixelWidthHint << " height hint: " << pixelHeightHint;
         throw std::runtime_error(errStream.str());
     }
+    return GlyphCache::Font{ft, face};
+}
+
+TextRenderer::TextRenderer(ShaderRegistry &shaderRegistry, const std::string &fontHint, const unsigned int pixelWidthHint,
+                           const unsigned int pixelHeightHint) :
+    textShader(shaderRegistry.getProgram("shaders/text.vert", "shaders/text.frag")),
+    backgroundShader(shaderRegistry.getProgram("shaders/textBackground.vert", "shaders/textBackground.frag")),
+    scaleUniform(textShader->getUniform<GLfloat>("scale")),
+    textOffsetUniform(textShader->getUniform<Vector2>("offset")),
+    backgroundOffsetUniform(backgroundShader->getUniform<Vector2>("offset")),
+    backgroundColorUniform(backgroundShader->getUniform<Vector3>("backgroundColor")),
+    glyphCache(openFont(fontHint, pixelWidthHint, pixelHeightHint))
+{
+    const FT_Face face = this->glyphCache.getFace();
     this->lineSpacing64thsPixel = static_cast<float>(face->size->metrics.height);
     this->descender64thsPixel = static_cast<float>(face->size->metrics.descender);
-    // Disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    // Generate the textures
-    glGenTextures(textures.size(), textures.data());
-    for (std::size_t c = 0; c < textures.size(); ++c) {
-        // Load the character glyph
-        ftErr = FT_Load_Char(face, c, FT_LOAD_RENDER);
-        if (ftErr) {
-            glDeleteTextures(textures.size(), textures.data());
-            FT_Done_Face(face);
-            FT_Done_FreeType(ft);
-            std::ostringstream errStream;
-            errStream << "FT_Load_Char failed on char " << c;
-            throw std::runtime_error(errStream.str());
-        }
-        glBindTexture(GL_TEXTURE_2D, textures[c]);
-        glTexImage2D(GL_TEXTURE_2D,
-                     0,
-                     GL_RED,
-                     face->glyph->bitmap.width,
-                     face->glyph->bitmap.rows,
-                     0,
-                     GL_RED,
-                     GL_UNSIGNED_BYTE,
-                     face->glyph->bitmap.buffer);
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        // Store the data
-        characters[c].size.width = face->glyph->bitmap.width;
-        characters[c].size.rows = face->glyph->bitmap.rows;
-        characters[c].bearing.left = face->glyph->bitmap_left;
-        characters[c].bearing.top = face->glyph->bitmap_top;
-        characters[c].advance = static_cast<float>(face->glyph->advance.x);
-    }
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
 
     // Create the VBO which will be used to render the text.
     glGenVertexArrays(1, &textVAO);
     glGenVertexArrays(1, &bgVAO);
     glGenBuffers(1, &textVBO);
     glGenBuffers(1, &bgVBO);
-    glBindVertexArray(textVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-    // We create a buffer of this size, which is enough for a square with texture coordinates.
-    // Remember that a square is two triangles, which explains the six. The triangles have a x,y coordinate and
-    // a x, y texture coordinate, which explains the four.
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-    // How the data should be interpret, so each vertex has 4 elements, no stride.
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glEnableVertexAttribArray(0);
-    // Unbind them all
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
-    // Now for the background
-    glBindVertexArray(bgVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, bgVBO);
-    // This is a simple, 2D square. Which is two triangles, which means 6 sets of 2 coordinates.
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 2, NULL, GL_DYNAMIC_DRAW);
-    // How the data should be interpret, so each vertex has 4 elements, no stride.
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0);
-    glEnableVertexAttribArray(0);
-
-    // Unbind
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    setUpGlyphArray(textVAO, textVBO);
+    setUpBackgroundArray(bgVAO, bgVBO);
 }
 
 TextRenderer::~TextRenderer(void)
 {
-    glDeleteTextures(textures.size(), textures.data());
     glDeleteVertexArrays(1, &textVAO);
     glDeleteVertexArrays(1, &bgVAO);
     glDeleteBuffers(1, &textVBO);
     glDeleteBuffers(1, &bgVBO);
 }
 
-void TextRenderer::renderBackground(const float y, const float x, const float height, const float length) const
+void TextRenderer::appendBackground(const float y, const float x, const float height, const float length,
+                                    TextLayout &layout) const
 {
-    float vertices[] = {
+    layout.backgroundVertices.insert(layout.backgroundVertices.end(), {
         // First triangle
         x + length, y + height, // Top right
         x + length, y,          // bottom right
@@ -250,65 +307,83 @@ void TextRenderer::renderBackground(const float y, const float x, const float he
         x + length, y,          // Bottom right
         x,          y,          // Bottom left
         x,          y + height, // Top left
-    };
-    (void)vertices;
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    });
 }
 
-void TextRenderer::renderText(const ProjectionMatrix& mat, const std::string &text, float x, float y, const float scale,
-                              const float maxLineLenPix,
-                              const VerticalAlignment vAlign,
-                              const HorizontalAlignment hAlign,
-                              const Vector3& textColor,
-                              const bool addBackgroundColor, const Vector3& backgroundColor) const
+void TextRenderer::layoutText(const std::string &text, const float scale, const float maxLineLenPix,
+                              const VerticalAlignment vAlign, const HorizontalAlignment hAlign,
+                              const Vector3& textColor, const bool addBackgroundColor, TextLayout &layout) const
 {
-    // Prepare the text shader
-    this->textShader.use();
-    textShader.setUniformMatrix4v("projection", 1, true, mat.data());
-    textShader.setUniform3f("textColor", textColor);
-    glActiveTexture(GL_TEXTURE0);
-    // Optionally prepare the background shader
-    if (addBackgroundColor) {
-        this->backgroundShader.use();
-        backgroundShader.setUniformMatrix4v("projection", 1, true, mat.data());
-        backgroundShader.setUniform3f("backgroundColor", backgroundColor);
-    }
-
-    // render
-    std::vector<std::string> strList = splitString(text, maxLineLenPix, scale);
+    layout.glyphs.clear();
+    layout.backgroundVertices.clear();
+    layout.pages = 0;
+    // The pages this text draws from must not be evicted before it is drawn.
+    this->glyphCache.beginUse();
+    const auto toByte = [](const float value) -> std::uint8_t {
+        return static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255));
+    };
+    const std::array<std::uint8_t, 4> color = {toByte(textColor[0]), toByte(textColor[1]), toByte(textColor[2]), 255};
+    // Text drawn every frame is usually the same as in the last one, so the line breaks are cached.
+    const std::vector<LineLayoutCache::Line> *lines = this->lineLayoutCache.find(text, scale, maxLineLenPix);
+    if (lines == nullptr)
+        lines = &this->lineLayoutCache.insert(text, scale, maxLineLenPix, splitString(text, maxLineLenPix, scale));
     // Process vAlign
-    // Top-left is ymax. The y-coordinate passed to renderTextLine represents the absolute bottom on which the glyph is drawn.
+    // Top-left is ymax. The y-coordinate passed to appendTextLine represents the absolute bottom on which the glyph is drawn.
     // So, to achieve TextRenderer::VerticalAlignment::Top, we subtract the box height plus the descender.
     // The descender is a negative number and represents the maximum amount any glyph will go below the given y line.
     float lineHeight = (this->lineSpacing64thsPixel / 64) * scale;
     float descender = (this->descender64thsPixel / 64) * scale;
-    y -= lineHeight + descender;
+    float y = -(lineHeight + descender);
     if (vAlign == TextRenderer::VerticalAlignment::center) {
-        y += (lineHeight * strList.size()) / 2;
+        y += (lineHeight * lines->size()) / 2;
     } else if (vAlign == TextRenderer::VerticalAlignment::bottom) {
-        y += (lineHeight * strList.size());
+        y += (lineHeight * lines->size());
     }
-    for (const std::string &s : strList) {
-        const float lineLen = getLineLengthPixels(s, scale);
-        float actX = x;
+    for (const LineLayoutCache::Line &line : *lines) {
+        const float lineLen = line.width;
+        float actX = 0;
         if (hAlign == TextRenderer::HorizontalAlignment::right) {
             actX -= lineLen;
         } else if (hAlign == TextRenderer::HorizontalAlignment::center) {
             actX -= lineLen / 2;
         }
-        if (addBackgroundColor) {
-            this->backgroundShader.use();
-            glBindVertexArray(bgVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, bgVBO);
-            renderBackground(y + descender, actX, lineHeight, lineLen);
-        }
-        this->textShader.use();
-        glBindVertexArray(textVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-        renderTextLine(s, actX, y, scale);
+        if (addBackgroundColor)
+            appendBackground(y + descender, actX, lineHeight, lineLen, layout);
+        appendTextLine(std::string_view(text).substr(line.begin, line.length), actX, y, scale, color, layout);
         y -= lineHeight;
     }
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+}
+
+void TextRenderer::renderText(const std::string &text, const float x, const float y, const float scale,
+                              const float maxLineLenPix,
+                              const VerticalAlignment vAlign,
+                              const HorizontalAlignment hAlign,
+                              const Vector3& textColor,
+                              const bool addBackgroundColor, const Vector3& backgroundColor) const
+{
+    // The text is laid out around (0, 0) and moved to (x, y) by the shaders, like a TextBlock.
+    layoutText(text, scale, maxLineLenPix, vAlign, hAlign, textColor, addBackgroundColor, this->scratchLayout);
+    upload(textVBO, bgVBO, this->scratchLayout, GL_STREAM_DRAW);
+    draw(textVAO, this->scratchLayout.glyphs.size(), bgVAO, this->scratchLayout.backgroundVertices.size() / 2,
+         this->scratchLayout.pages, Vector2(x, y), scale, backgroundColor);
+}
+
+const TextRenderer::DrawStatistics& TextRenderer::getDrawStatistics(void) const noexcept
+{
+    return this->statistics;
+}
+
+const LineLayoutCache::Statistics& TextRenderer::getLayoutCacheStatistics(void) const noexcept
+{
+    return this->lineLayoutCache.getStatistics();
+}
+
+const GlyphCache::Statistics& TextRenderer::getGlyphCacheStatistics(void) const noexcept
+{
+    return this->glyphCache.getStatistics();
+}
+
+void TextRenderer::resetDrawStatistics(void) noexcept
+{
+    this->statistics = DrawStatistics{};
 }
@@ -0,0 +1,64 @@
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "trig.hpp"
+
+void Trig::fastSinCos(const float* x, float* sin, float* cos, const std::size_t count) noexcept
+{
+    std::size_t i = 0;
+#ifdef __SSE2__
+    // fastSinCos(float), four angles at a time. The quadrant selection uses masks instead of the ternary operators.
+    using namespace Detail;
+    const __m128 twoOverPiVec = _mm_set1_ps(twoOverPi);
+    const __m128 roundingVec = _mm_set1_ps(roundingConstant);
+    const __m128 limitVec = _mm_set1_ps(quadrantLimit);
+    const __m128 negativeLimitVec = _mm_set1_ps(-quadrantLimit);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 angles = _mm_loadu_ps(x + i);
+        const __m128 rounded = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(angles, twoOverPiVec), roundingVec), roundingVec);
+        const __m128i quadrant = _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(rounded, limitVec), negativeLimitVec));
+        __m128 r = _mm_sub_ps(angles, _mm_mul_ps(rounded, _mm_set1_ps(piOverTwo1)));
+        r = _mm_sub_ps(r, _mm_mul_ps(rounded, _mm_set1_ps(piOverTwo2)));
+        r = _mm_sub_ps(r, _mm_mul_ps(rounded, _mm_set1_ps(piOverTwo3)));
+        const __m128 r2 = _mm_mul_ps(r, r);
+
+        __m128 sinPoly = _mm_add_ps(_mm_set1_ps(sin2), _mm_mul_ps(r2, _mm_set1_ps(sin3)));
+        sinPoly = _mm_add_ps(_mm_set1_ps(sin1), _mm_mul_ps(r2, sinPoly));
+        const __m128 s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), sinPoly));
+        __m128 cosPoly = _mm_add_ps(_mm_set1_ps(cos2), _mm_mul_ps(r2, _mm_set1_ps(cos3)));
+        cosPoly = _mm_add_ps(_mm_set1_ps(cos1), _mm_mul_ps(r2, cosPoly));
+        const __m128 c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1), _mm_mul_ps(_mm_set1_ps(0.5f), r2)),
+                                    _mm_mul_ps(_mm_mul_ps(r2, r2), cosPoly));
+
+        const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+        const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+        const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+        const __m128 sinRes = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+        const __m128 cosRes = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+        _mm_storeu_ps(sin + i, _mm_xor_ps(sinRes, sinSign));
+        _mm_storeu_ps(cos + i, _mm_xor_ps(cosRes, cosSign));
+    }
+#endif
+    for (; i < count; ++i) {
+        const SinCos res = fastSinCos(x[i]);
+        sin[i] = res.sin;
+        cos[i] = res.cos;
+    }
+}
+
+void Trig::sinCos(const float* x, float* sin, float* cos, const std::size_t count) noexcept
+{
+#ifdef FAST_TRIG
+    fastSinCos(x, sin, cos, count);
+#else
+    for (std::size_t i = 0; i < count; ++i) {
+        sin[i] = std::sin(x[i]);
+        cos[i] = std::cos(x[i]);
+    }
+#endif
+}
@@ -0,0 +1,70 @@
+#include <bit>
+
+#include "uniformTable.hpp"
+#include "fnv1a.hpp"
+
+std::uint64_t UniformTable::hash(const std::string_view name) noexcept
+{
+    return Fnv1a::hash(name);
+}
+
+void UniformTable::insert(const Uniform &uniform)
+{
+    const std::uint64_t h = hash(uniform.name);
+    const std::size_t mask = this->slots.size() - 1;
+    for (std::size_t i = h & mask; ; i = (i + 1) & mask) {
+        Slot &slot = this->slots[i];
+        if (slot.uniform.name.empty()) {
+            slot = Slot{h, uniform};
+            return;
+        }
+    }
+}
+
+UniformTable::UniformTable(const GLuint program)
+{
+    GLint count = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::vector<Uniform> uniforms;
+    std::string name(static_cast<std::size_t>(maxNameLength), '\0');
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        Uniform uniform;
+        glGetActiveUniform(program, static_cast<GLuint>(i), maxNameLength, &length, &uniform.size, &uniform.type,
+                           name.data());
+        uniform.name.assign(name.data(), static_cast<std::size_t>(length));
+        uniform.location = glGetUniformLocation(program, uniform.name.c_str());
+        if (uniform.location == -1)
+            continue;
+        uniforms.push_back(uniform);
+        const std::string::size_type arraySuffix = uniform.name.rfind("[0]");
+        if (arraySuffix != std::string::npos && arraySuffix + 3 == uniform.name.size()) {
+            uniform.name.resize(arraySuffix);
+            uniforms.push_back(uniform);
+        }
+    }
+
+    this->slots.resize(std::bit_ceil(2 * uniforms.size() + 1));
+    for (const Uniform &uniform : uniforms) {
+        insert(uniform);
+    }
+}
+
+const UniformTable::Uniform* UniformTable::find(const std::string_view name) const noexcept
+{
+    if (this->slots.empty())
+        return nullptr;
+    const std::uint64_t h = hash(name);
+    const std::size_t mask = this->slots.size() - 1;
+    // The table is never full, so there always is a free slot which ends the search.
+    for (std::size_t i = h & mask; ; i = (i + 1) & mask) {
+        const Slot &slot = this->slots[i];
+        if (slot.uniform.name.empty())
+            return nullptr;
+        if (slot.hash == h && slot.uniform.name == name)
+            return &slot.uniform;
+    }
+}
@@ -1,5 +1,7 @@
 #include <cmath>
 
+#include "lookAtMatrix.hpp"
+#include "trig.hpp"
 #include "viewMatrix.hpp"
 
 void ViewMatrix::processKeyPress(const int key, const int scancode, const int action, const int mods)
@@ -39,9 +41,11 @@ void ViewMatrix::processWindowFocus(const bool focused)
 
 Vector3 ViewMatrix::getCameraFront(const float pitch, const float yaw) const
 {
-    float x = std::cos(yaw) * std::cos(pitch);
-    float y = std::sin(pitch);
-    float z = std::sin(yaw) * std::cos(pitch);
+    const Trig::SinCos yawSinCos = Trig::sinCos(yaw);
+    const Trig::SinCos pitchSinCos = Trig::sinCos(pitch);
+    float x = yawSinCos.cos * pitchSinCos.cos;
+    float y = pitchSinCos.sin;
+    float z = yawSinCos.sin * pitchSinCos.cos;
     // CameraFront is the rotation of the camera.
     return Vector3::normalize(Vector3(x, y, z));
 }
@@ -59,25 +63,6 @@ void ViewMatrix::unregisterGlfwWindow(void)
     this->glfwWindow = nullptr;
 }
 
-Matrix4 ViewMatrix::getLookAtMatrix(const Vector3 &worldUp, const Vector3 &cameraDirection, const Vector3 &cameraPos) const
-{
-    Vector3 cameraRight = Vector3::normalize(Vector3::crossProduct(worldUp, cameraDirection));
-    Vector3 cameraUp = Vector3::normalize(Vector3::crossProduct(cameraDirection, cameraRight));
-    Matrix4 axisMat({
-        cameraRight.x(),        cameraRight.y(),        cameraRight.z(),        0,
-        cameraUp.x(),           cameraUp.y(),           cameraUp.z(),           0,
-        cameraDirection.x(),    cameraDirection.y(),    cameraDirection.z(),    0,
-        0,                      0,                      0,                      1,
-    });
-    Matrix4 posMat({
-        1,  0,  0,  -cameraPos.x(),
-        0,  1,  0,  -cameraPos.y(),
-        0,  0,  1,  -cameraPos.z(),
-        0,  0,  0,  1,
-    });
-    return axisMat * posMat;
-}
-
 ViewMatrix::ViewMatrix(const float sensitivity, const float moveSpeed) : sensitivity(sensitivity), moveSpeed(moveSpeed), pitchLimit(89.0*M_PI/180.0)
 {
     upActive = downActive = leftActive = rightActive = false;
@@ -104,7 +89,7 @@ ViewMatrix::~ViewMatrix(void)
 void ViewMatrix::update(void)
 {
     // World up is a definition
-    const Vector3 worldUp = Vector3(0, 1, 0);
+    constexpr Vector3 worldUp = Vector3(0, 1, 0);
 
     float currentTime = glfwGetTime();
     float deltaTime = currentTime - prevTime;
@@ -140,7 +125,8 @@ void ViewMatrix::update(void)
     cameraPos += leftRightMovement * leftRightDirection * cameraSpeed;
 
     // Update the lookAtMatrix
-    lookAtMatrix = getLookAtMatrix(worldUp, cameraDirection, cameraPos);
+    lookAtMatrix = createLookAtMatrix(worldUp, cameraDirection, cameraPos);
+    columnMajorLookAtMatrix = ColumnMajorMatrix4(lookAtMatrix);
 }
 
 void ViewMatrix::registerWithGlfwWindow(GlfwWindow &w)
@@ -170,3 +156,18 @@ const float* ViewMatrix::data() const noexcept
 {
     return this->lookAtMatrix.data();
 }
+
+const float* ViewMatrix::columnMajorData() const noexcept
+{
+    return this->columnMajorLookAtMatrix.data();
+}
+
+const Matrix4& ViewMatrix::getMatrix(void) const noexcept
+{
+    return this->lookAtMatrix;
+}
+
+const Vector3& ViewMatrix::getCameraPosition(void) const noexcept
+{
+    return this->cameraPos;
+}
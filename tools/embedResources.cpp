@@ -0,0 +1,112 @@
+/**Build tool which writes a C++ source file with the contents of the given files, for inc/embeddedResources.hpp.
+ * Usage: embedResources output.cpp [name=]file...
+ * Every file is embedded under its path, or under name if one is given. See the Makefile for how it is used.*/
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Input {
+        std::string name;
+        std::string path;
+    };
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "embedResources: cannot read " << path << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    /**Write data as a string literal. Octal escapes have at most three digits, so a digit after one needs no care,
+     * unlike after a hexadecimal escape. Long literals are split, a compiler handles them faster than an array
+     * initializer with one element per byte.*/
+    void writeLiteral(std::ostream &out, const std::string &data)
+    {
+        constexpr std::size_t lineLength = 100;
+        std::size_t column = 0;
+        out << "    \"";
+        for (const char c : data) {
+            const unsigned char byte = static_cast<unsigned char>(c);
+            if (column >= lineLength) {
+                out << "\"\n    \"";
+                column = 0;
+            }
+            if (byte == '\n') {
+                out << "\\n\"\n    \"";
+                column = 0;
+            } else if (byte == '\\' || byte == '"') {
+                out << '\\' << c;
+                column += 2;
+            } else if (byte == '?') {
+                // Avoids trigraphs.
+                out << "\\?";
+                column += 2;
+            } else if (byte >= 0x20 && byte < 0x7F) {
+                out << c;
+                column += 1;
+            } else {
+                out << '\\' << static_cast<char>('0' + (byte >> 6)) << static_cast<char>('0' + ((byte >> 3) & 7))
+                    << static_cast<char>('0' + (byte & 7));
+                column += 4;
+            }
+        }
+        out << "\"";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " output.cpp [name=]file...\n";
+        return EXIT_FAILURE;
+    }
+    std::vector<Input> inputs;
+    for (int i = 2; i < argc; ++i) {
+        const std::string argument = argv[i];
+        const std::string::size_type separator = argument.find('=');
+        if (separator == std::string::npos)
+            inputs.push_back(Input{argument, argument});
+        else
+            inputs.push_back(Input{argument.substr(0, separator), argument.substr(separator + 1)});
+    }
+
+    std::ostringstream out;
+    out << "// Generated by tools/embedResources.cpp, do not edit.\n"
+        << "#include \"embeddedResources.hpp\"\n\n"
+        << "namespace {\n";
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        out << "    // " << inputs[i].path << "\n"
+            << "    constexpr char data" << i << "[] =\n";
+        writeLiteral(out, readFile(inputs[i].path));
+        out << ";\n";
+    }
+    out << "    constexpr EmbeddedResources::Resource entries[] = {\n";
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        out << "        {\"" << inputs[i].name << "\", std::string_view(data" << i << ", sizeof(data" << i
+            << ") - 1)},\n";
+    }
+    // An array cannot be empty.
+    if (inputs.empty())
+        out << "        {\"\", std::string_view()},\n";
+    out << "    };\n"
+        << "}\n\n"
+        << "const std::span<const EmbeddedResources::Resource> EmbeddedResources::Detail::resources(entries, "
+        << inputs.size() << ");\n";
+
+    std::ofstream file(argv[1], std::ios::binary);
+    file << out.str();
+    if (!file.flush()) {
+        std::cerr << "embedResources: cannot write " << argv[1] << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}